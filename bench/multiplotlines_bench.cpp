@@ -0,0 +1,357 @@
+//----------------------------------------------------------------
+// ImGui::MultiPlotLines headless benchmark
+//----------------------------------------------------------------
+// Times ImGui::MultiPlotLines() without a rendering backend, over a
+// sweep of num_values, num_channels, plot widths, line thickness,
+// legend, decimation and autoscale range caching, and reports per
+// configuration:
+// - ns_frame: NewFrame() to Render(), ns_plot: MultiPlotLines() call
+// - get_value_calls: get_value() calls per frame
+// - vtx_count, idx_count: ImDrawData totals per frame
+//
+// With --lanes, compares eL_Overlay and eL_Lanes single calls against
+// one single-channel widget per channel stacked vertically ("widgets",
+// the way per-channel ranges were drawn before eL_Lanes).
+//
+// With --history, measures MultiPlotLines_History instead, over a few
+// signals and MantissaBits, and reports per configuration:
+// - raw_bytes, compressed_bytes, ratio: memory as floats vs compressed
+// - encode_mvps: Push() throughput, in million values per second
+// - decode_mvps: sequential GetValues() throughput, in million values per second
+// - range_ns: full-history GetChannelRange() per channel, from block headers
+//
+// Usage:
+//   multiplotlines_bench [--json] [--quick] [--lanes] [--history] [--frames N] [--min-ms T]
+// Prints CSV by default, or a JSON array with --json.
+#include "imgui_multiplotlines.h"
+#include "imgui_multiplotlines_history.h"
+#include <imgui/imgui.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+
+namespace
+{
+
+typedef std::chrono::steady_clock Clock;
+
+struct Config
+{
+    int   NumValues;
+    int   NumChannels;
+    float Width;
+    float Thickness;
+    bool  bLegend;
+    int   Decimation;
+    int   Layout; //ELayout
+    bool  bRangeCache; //Non-zero DataGeneration, otherwise autoscale scans all values every frame
+};
+
+// eL_Overlay and eL_Lanes in a single call, or a widget per channel
+enum ELayout { eL_Overlay, eL_Lanes, eL_Widgets };
+const char* c_LayoutNames[] = { "overlay", "lanes", "widgets" };
+
+struct Result
+{
+    int    NumFrames;
+    double NsPerFrame;
+    double NsPerPlot;
+    double GetValueCalls;
+    int    VtxCount;
+    int    IdxCount;
+};
+
+// Deterministic noisy signal, counts calls
+long long g_NumGetValueCalls = 0;
+float GetValue( void* data, int value_idx, int channel_idx )
+{
+    g_NumGetValueCalls++;
+    if( data ) //eL_Widgets channel
+        channel_idx += *(const int*)data;
+    const float t = float(value_idx) * 0.001f;
+    return sinf( t * float(channel_idx+1) ) + 0.1f * sinf( 12.9898f * float(value_idx) + 78.233f * float(channel_idx) );
+}
+
+const char* c_DecimationNames[] = { "none", "minmax", "lttb" };
+
+// One frame submitting a single plot in a borderless window, returns MultiPlotLines() ns
+double RunFrame( const Config& config, ImGui::MultiPlotLines_Params& params )
+{
+    ImGuiIO& io = ImGui::GetIO();
+    io.DeltaTime = 1.0f / 60.0f;
+    ImGui::NewFrame();
+    ImGui::SetNextWindowPos( ImVec2(0.0f,0.0f) );
+    ImGui::SetNextWindowSize( io.DisplaySize );
+    ImGui::Begin( "Bench", nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoSavedSettings );
+    const Clock::time_point t0 = Clock::now();
+    if( config.Layout == eL_Widgets )
+    {
+        // Same plot height as an eL_Lanes lane, plus frame padding, so
+        // widgets take more than the 300px of the single call. The
+        // window is DisplaySize tall so that 64 of them fit unclipped
+        const ImGuiStyle& style = ImGui::GetStyle();
+        const float inner_height = 300.0f - 2.0f * style.FramePadding.y;
+        const float lane_height = (inner_height - params.LaneSpacing * (config.NumChannels-1)) / config.NumChannels;
+        const float height = (lane_height > 1.0f ? lane_height : 1.0f) + 2.0f * style.FramePadding.y;
+        for( int it_channel=0; it_channel<config.NumChannels; it_channel++ )
+        {
+            ImGui::PushID( it_channel );
+            ImGui::MultiPlotLines( "##Bench", GetValue, &it_channel, config.NumValues, 1, &params,
+                                   FLT_MAX, FLT_MAX, ImVec2( config.Width, height ) );
+            ImGui::PopID();
+        }
+    }
+    else
+        ImGui::MultiPlotLines( "##Bench", GetValue, nullptr, config.NumValues, config.NumChannels, &params,
+                               FLT_MAX, FLT_MAX, ImVec2( config.Width, 300.0f ) );
+    const Clock::time_point t1 = Clock::now();
+    ImGui::End();
+    ImGui::Render();
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>( t1 - t0 ).count();
+}
+
+Result Run( const Config& config, int max_frames, double min_ms )
+{
+    ImGui::MultiPlotLines_Params params;
+    params.DataGeneration = config.bRangeCache ? 1 : 0; //values never change, as in MultiPlotLines_Demo()
+    params.PlotDrawThickness = config.Thickness;
+    params.RW_ShowLegend = config.bLegend;
+    params.Decimation = config.Decimation;
+    params.Layout = config.Layout == eL_Lanes ? (int)ImGui::MultiPlotLines_Params::eL_Lanes : (int)ImGui::MultiPlotLines_Params::eL_Overlay;
+
+    // Warm up caches (ranges, default channel table, ImGui windows)
+    RunFrame( config, params );
+
+    Result result = {};
+    g_NumGetValueCalls = 0;
+    double plot_ns = 0.0;
+    const Clock::time_point t0 = Clock::now();
+    double elapsed_ms = 0.0;
+    while( result.NumFrames < 3 || (result.NumFrames < max_frames && elapsed_ms < min_ms) )
+    {
+        plot_ns += RunFrame( config, params );
+        result.NumFrames++;
+        elapsed_ms = std::chrono::duration<double,std::milli>( Clock::now() - t0 ).count();
+    }
+    const ImDrawData* draw_data = ImGui::GetDrawData();
+    result.NsPerFrame = elapsed_ms * 1e6 / result.NumFrames;
+    result.NsPerPlot = plot_ns / result.NumFrames;
+    result.GetValueCalls = double(g_NumGetValueCalls) / result.NumFrames;
+    result.VtxCount = draw_data->TotalVtxCount;
+    result.IdxCount = draw_data->TotalIdxCount;
+    return result;
+}
+
+// History sweep signals, noise is deterministic
+const char* c_SignalNames[] = { "sine", "sine_noise", "steps", "random" };
+float HistorySignal( int signal, int value_idx, int channel_idx )
+{
+    const float t = float(value_idx) * 0.001f * float(channel_idx+1);
+    const float noise = sinf( 12.9898f * float(value_idx) + 78.233f * float(channel_idx) ) * 43758.5453f;
+    const float unit_noise = noise - floorf(noise); //[0,1)
+    switch( signal )
+    {
+    case 0: return sinf( t );
+    case 1: return sinf( t ) + 0.05f * unit_noise;
+    case 2: return floorf( 8.0f * sinf( 0.1f * t ) ); //quantized sensor
+    default: return 2.0f * unit_noise - 1.0f;
+    }
+}
+
+struct HistoryResult
+{
+    size_t RawBytes;
+    size_t CompressedBytes;
+    double EncodeMvps;
+    double DecodeMvps;
+    double RangeNs;
+};
+
+HistoryResult RunHistory( int signal, int mantissa_bits, int num_channels, int num_values )
+{
+    ImGui::MultiPlotLines_History history;
+    history.MantissaBits = mantissa_bits;
+    history.Init( num_channels );
+    ImVector<float> frames;
+    frames.resize( num_values * num_channels );
+    for( int it_value=0; it_value<num_values; it_value++ )
+        for( int it_channel=0; it_channel<num_channels; it_channel++ )
+            frames[it_value*num_channels + it_channel] = HistorySignal( signal, it_value, it_channel );
+
+    HistoryResult result = {};
+    const double num_mvalues = double(num_values) * num_channels * 1e-6;
+    Clock::time_point t0 = Clock::now();
+    for( int it_value=0; it_value<num_values; it_value++ )
+        history.Push( &frames[it_value*num_channels] );
+    result.EncodeMvps = num_mvalues / std::chrono::duration<double>( Clock::now() - t0 ).count();
+    result.RawBytes = history.GetRawBytes();
+    result.CompressedBytes = history.GetCompressedBytes();
+
+    // Sequential decode in MultiPlotLines() sized chunks
+    float chunk[1024];
+    float checksum = 0.0f;
+    t0 = Clock::now();
+    for( int it_channel=0; it_channel<num_channels; it_channel++ )
+        for( int it_value=0; it_value<num_values; it_value+=IM_ARRAYSIZE(chunk) )
+        {
+            const int count = num_values - it_value < IM_ARRAYSIZE(chunk) ? num_values - it_value : IM_ARRAYSIZE(chunk);
+            ImGui::MultiPlotLines_History::GetValues( &history, it_value, count, it_channel, chunk );
+            checksum += chunk[0];
+        }
+    result.DecodeMvps = num_mvalues / std::chrono::duration<double>( Clock::now() - t0 ).count();
+
+    // Unaligned full-history ranges, as autoscale requests them
+    const int num_repeats = 16;
+    t0 = Clock::now();
+    for( int it_repeat=0; it_repeat<num_repeats; it_repeat++ )
+        for( int it_channel=0; it_channel<num_channels; it_channel++ )
+        {
+            float v_min = FLT_MAX, v_max = -FLT_MAX;
+            ImGui::MultiPlotLines_History::GetChannelRange( &history, it_channel, it_repeat+1, num_values-2*it_repeat-1, &v_min, &v_max );
+            checksum += v_max - v_min;
+        }
+    result.RangeNs = std::chrono::duration<double,std::nano>( Clock::now() - t0 ).count() / (num_repeats * num_channels);
+    if( checksum != checksum )
+        fprintf( stderr, "NaN checksum\n" );
+    return result;
+}
+
+int RunHistorySweep( bool bJson, bool bQuick )
+{
+    const int num_channels = bQuick ? 16 : 64;
+    const int num_values = bQuick ? 20000 : 200000;
+    const int c_MantissaBits[] = { 23, 12 };
+    if( bJson )
+        printf( "[\n" );
+    else
+        printf( "signal,mantissa_bits,num_channels,num_values,raw_bytes,compressed_bytes,ratio,encode_mvps,decode_mvps,range_ns\n" );
+    bool bFirst = true;
+    for( int it_signal=0; it_signal<IM_ARRAYSIZE(c_SignalNames); it_signal++ )
+    for( int it_bits=0; it_bits<IM_ARRAYSIZE(c_MantissaBits); it_bits++ )
+    {
+        const HistoryResult result = RunHistory( it_signal, c_MantissaBits[it_bits], num_channels, num_values );
+        const double ratio = double(result.RawBytes) / double(result.CompressedBytes);
+        if( bJson )
+            printf( "%s  {\"signal\":\"%s\",\"mantissa_bits\":%d,\"num_channels\":%d,\"num_values\":%d,\"raw_bytes\":%zu,\"compressed_bytes\":%zu,"
+                    "\"ratio\":%.3f,\"encode_mvps\":%.1f,\"decode_mvps\":%.1f,\"range_ns\":%.0f}",
+                    bFirst ? "" : ",\n",
+                    c_SignalNames[it_signal], c_MantissaBits[it_bits], num_channels, num_values, result.RawBytes, result.CompressedBytes,
+                    ratio, result.EncodeMvps, result.DecodeMvps, result.RangeNs );
+        else
+            printf( "%s,%d,%d,%d,%zu,%zu,%.3f,%.1f,%.1f,%.0f\n",
+                    c_SignalNames[it_signal], c_MantissaBits[it_bits], num_channels, num_values, result.RawBytes, result.CompressedBytes,
+                    ratio, result.EncodeMvps, result.DecodeMvps, result.RangeNs );
+        fflush( stdout );
+        bFirst = false;
+    }
+    if( bJson )
+        printf( "\n]\n" );
+    return 0;
+}
+
+} //namespace
+
+int main( int argc, char** argv )
+{
+    bool bJson = false;
+    bool bQuick = false;
+    bool bLanes = false;
+    bool bHistory = false;
+    int max_frames = 100;
+    double min_ms = 200.0;
+    for( int it_arg=1; it_arg<argc; it_arg++ )
+    {
+        if( !strcmp( argv[it_arg], "--json" ) )
+            bJson = true;
+        else if( !strcmp( argv[it_arg], "--quick" ) )
+            bQuick = true;
+        else if( !strcmp( argv[it_arg], "--lanes" ) )
+            bLanes = true;
+        else if( !strcmp( argv[it_arg], "--history" ) )
+            bHistory = true;
+        else if( !strcmp( argv[it_arg], "--frames" ) && it_arg+1 < argc )
+            max_frames = atoi( argv[++it_arg] );
+        else if( !strcmp( argv[it_arg], "--min-ms" ) && it_arg+1 < argc )
+            min_ms = atof( argv[++it_arg] );
+        else
+        {
+            fprintf( stderr, "Usage: %s [--json] [--quick] [--lanes] [--history] [--frames N] [--min-ms T]\n", argv[0] );
+            return 1;
+        }
+    }
+    if( bHistory )
+        return RunHistorySweep( bJson, bQuick );
+
+    // Headless context, fonts must be built before NewFrame()
+    ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO();
+    io.IniFilename = nullptr;
+    io.LogFilename = nullptr;
+    io.DisplaySize = ImVec2( 2048.0f, 2048.0f );
+    // Large undecimated configs emit more than 64K vertices per window,
+    // which needs ImDrawCmd::VtxOffset with 16-bit ImDrawIdx, as in any
+    // recent renderer backend
+    io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;
+    unsigned char* pixels;
+    int tex_width, tex_height;
+    io.Fonts->GetTexDataAsRGBA32( &pixels, &tex_width, &tex_height );
+
+    // Sweep, --lanes only varies layout on wide plots of many channels
+    const int   c_NumValues[]      = { 1000, 10000, 100000 };
+    const int   c_NumChannels[]    = { 1, 8, 64 };
+    const int   c_LanesChannels[]  = { 8, 64 };
+    const float c_Widths[]         = { 256.0f, 1024.0f };
+    const float c_Thickness[]      = { 1.0f, 2.0f };
+    const int   c_Decimation[]     = { ImGui::MultiPlotLines_Params::eD_None, ImGui::MultiPlotLines_Params::eD_MinMax, ImGui::MultiPlotLines_Params::eD_LTTB };
+    const int num_values_count = bQuick ? 2 : IM_ARRAYSIZE(c_NumValues);
+    const int num_channels_count = bLanes ? (bQuick ? 1 : IM_ARRAYSIZE(c_LanesChannels)) : (bQuick ? 2 : IM_ARRAYSIZE(c_NumChannels));
+    const int* channels = bLanes ? c_LanesChannels + (bQuick ? 1 : 0) : c_NumChannels;
+    const int num_widths = bQuick || bLanes ? 1 : IM_ARRAYSIZE(c_Widths);
+    const int first_width = bLanes ? 1 : 0;
+    const int num_thickness = bQuick || bLanes ? 1 : IM_ARRAYSIZE(c_Thickness);
+    const int num_legend = bLanes ? 1 : 2;
+    const int num_decimation = bQuick || bLanes ? 2 : IM_ARRAYSIZE(c_Decimation);
+    const int num_range_cache = bLanes ? 1 : 2;
+    const int num_layouts = bLanes ? IM_ARRAYSIZE(c_LayoutNames) : 1;
+
+    if( bJson )
+        printf( "[\n" );
+    else
+        printf( "num_values,num_channels,width,thickness,legend,decimation,layout,range_cache,frames,ns_frame,ns_plot,get_value_calls,vtx_count,idx_count\n" );
+    bool bFirst = true;
+    for( int it_values=0; it_values<num_values_count; it_values++ )
+    for( int it_channels=0; it_channels<num_channels_count; it_channels++ )
+    for( int it_width=0; it_width<num_widths; it_width++ )
+    for( int it_thickness=0; it_thickness<num_thickness; it_thickness++ )
+    for( int it_legend=0; it_legend<num_legend; it_legend++ )
+    for( int it_decimation=0; it_decimation<num_decimation; it_decimation++ )
+    for( int it_layout=0; it_layout<num_layouts; it_layout++ )
+    for( int it_range_cache=0; it_range_cache<num_range_cache; it_range_cache++ )
+    {
+        const Config config = { c_NumValues[it_values], channels[it_channels], c_Widths[first_width + it_width],
+                                c_Thickness[it_thickness], it_legend != 0, c_Decimation[it_decimation], it_layout,
+                                bLanes || it_range_cache != 0 };
+        const Result result = Run( config, max_frames, min_ms );
+        if( bJson )
+            printf( "%s  {\"num_values\":%d,\"num_channels\":%d,\"width\":%g,\"thickness\":%g,\"legend\":%s,\"decimation\":\"%s\",\"layout\":\"%s\",\"range_cache\":%s,"
+                    "\"frames\":%d,\"ns_frame\":%.0f,\"ns_plot\":%.0f,\"get_value_calls\":%.0f,\"vtx_count\":%d,\"idx_count\":%d}",
+                    bFirst ? "" : ",\n",
+                    config.NumValues, config.NumChannels, config.Width, config.Thickness, config.bLegend ? "true" : "false",
+                    c_DecimationNames[config.Decimation], c_LayoutNames[config.Layout], config.bRangeCache ? "true" : "false",
+                    result.NumFrames, result.NsPerFrame, result.NsPerPlot, result.GetValueCalls, result.VtxCount, result.IdxCount );
+        else
+            printf( "%d,%d,%g,%g,%d,%s,%s,%d,%d,%.0f,%.0f,%.0f,%d,%d\n",
+                    config.NumValues, config.NumChannels, config.Width, config.Thickness, config.bLegend ? 1 : 0,
+                    c_DecimationNames[config.Decimation], c_LayoutNames[config.Layout], config.bRangeCache ? 1 : 0,
+                    result.NumFrames, result.NsPerFrame, result.NsPerPlot, result.GetValueCalls, result.VtxCount, result.IdxCount );
+        fflush( stdout );
+        bFirst = false;
+    }
+    if( bJson )
+        printf( "\n]\n" );
+
+    ImGui::DestroyContext();
+    return 0;
+}
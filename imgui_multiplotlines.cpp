@@ -1,24 +1,1211 @@
 //----------------------------------------------------------------
 // ImGui::MultiPlotLines
 //----------------------------------------------------------------
-#include "imgui_multiplotlines.h"
+#include "imgui_multiplotlines_internal.h"
 #ifndef IMGUI_DEFINE_MATH_OPERATORS
 #define IMGUI_DEFINE_MATH_OPERATORS
 #endif
 #include <imgui/imgui_internal.h>
+#include <math.h> //NAN, fmodf
+#include <chrono>
+
+// SIMD kernels, define IMGUI_MULTIPLOTLINES_DISABLE_SIMD to use scalar fallbacks
+#if !defined(IMGUI_MULTIPLOTLINES_DISABLE_SIMD)
+#  if defined(__AVX__)
+#    include <immintrin.h>
+#    define IMGUI_MULTIPLOTLINES_AVX
+#  elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    include <emmintrin.h>
+#    define IMGUI_MULTIPLOTLINES_SSE2
+#  endif
+#endif
 
 namespace ImGui
 {
 
-void MultiPlotLines( const char* label,
-                     float (*get_value)(void* data, int value_idx, int channel_idx),
-                     void* data,
-                     int num_values,
-                     int num_channels,
-                     MultiPlotLines_Params* params,
-                     float scale_min, float scale_max,
-                     ImVec2 frame_size )
+//----------------------------------------------------------------
+// ImGui::MultiPlotLinesInternal
+//----------------------------------------------------------------
+namespace MultiPlotLinesInternal
+{
+
+void AccumulateMinMax( const float* values, int num_values, float& v_min, float& v_max )
 {
+    int i = 0;
+    // NOTE: SIMD min/max return their 2nd operand if either is NaN,
+    // so NaN values never replace the accumulated ones
+#if defined(IMGUI_MULTIPLOTLINES_AVX)
+    if( num_values >= 16 )
+    {
+        __m256 min0 = _mm256_set1_ps(v_min), min1 = min0;
+        __m256 max0 = _mm256_set1_ps(v_max), max1 = max0;
+        for( ; i+16 <= num_values; i+=16 )
+        {
+            const __m256 v0 = _mm256_loadu_ps(values+i);
+            const __m256 v1 = _mm256_loadu_ps(values+i+8);
+            min0 = _mm256_min_ps(v0,min0); max0 = _mm256_max_ps(v0,max0);
+            min1 = _mm256_min_ps(v1,min1); max1 = _mm256_max_ps(v1,max1);
+        }
+        float tmp_min[8], tmp_max[8];
+        _mm256_storeu_ps( tmp_min, _mm256_min_ps(min0,min1) );
+        _mm256_storeu_ps( tmp_max, _mm256_max_ps(max0,max1) );
+        for( int k=0; k<8; k++ )
+        {
+            v_min = ImMin( v_min, tmp_min[k] );
+            v_max = ImMax( v_max, tmp_max[k] );
+        }
+    }
+#elif defined(IMGUI_MULTIPLOTLINES_SSE2)
+    if( num_values >= 8 )
+    {
+        __m128 min0 = _mm_set1_ps(v_min), min1 = min0;
+        __m128 max0 = _mm_set1_ps(v_max), max1 = max0;
+        for( ; i+8 <= num_values; i+=8 )
+        {
+            const __m128 v0 = _mm_loadu_ps(values+i);
+            const __m128 v1 = _mm_loadu_ps(values+i+4);
+            min0 = _mm_min_ps(v0,min0); max0 = _mm_max_ps(v0,max0);
+            min1 = _mm_min_ps(v1,min1); max1 = _mm_max_ps(v1,max1);
+        }
+        float tmp_min[4], tmp_max[4];
+        _mm_storeu_ps( tmp_min, _mm_min_ps(min0,min1) );
+        _mm_storeu_ps( tmp_max, _mm_max_ps(max0,max1) );
+        for( int k=0; k<4; k++ )
+        {
+            v_min = ImMin( v_min, tmp_min[k] );
+            v_max = ImMax( v_max, tmp_max[k] );
+        }
+    }
+#endif
+    // Remaining values, NaN comparisons are false so they're ignored too
+    for( ; i<num_values; i++ )
+    {
+        const float v = values[i];
+        v_min = v < v_min ? v : v_min;
+        v_max = v > v_max ? v : v_max;
+    }
+}
+
+} //namespace MultiPlotLinesInternal
+
+namespace
+{
+
+using MultiPlotLinesInternal::AccumulateMinMax;
+using MultiPlotLinesInternal::CountTrailingZeros;
+
+typedef void gvs_fn_t( void* data, int first_value_idx, int num_values, int channel_idx, float* values );
+
+// Chunked access to channel values, all passes (scale, hover, draw)
+// fetch contiguous chunks of values instead of individual ones.
+//
+// Value indices are logical, value_idx is fetched from physical index
+// (value_idx + values_offset) % num_values, so chunks that wrap around
+// are split in (at most) 2 get_values() calls.
+struct ValueSource
+{
+    enum EConstants { cChunkSize = 1024 };
+    gvs_fn_t* get_values;
+    void* data;
+    int num_values;
+    int values_offset; //in [0,num_values)
+    // Optional range query, uses physical indices too
+    const MultiPlotLines_Params::gcr_fn_t* get_range;
+    const void* range_data;
+    // Optional counters, only touched by the thread that owns them
+    MultiPlotLines_Stats* stats;
+
+    void GetValues( int first_value_idx, int count, int channel_idx, float* values ) const
+    {
+        int physical_first = first_value_idx + values_offset;
+        if( physical_first >= num_values )
+            physical_first -= num_values;
+        const int count0 = ImMin( count, num_values - physical_first );
+        get_values( data, physical_first, count0, channel_idx, values );
+        if( count0 < count )
+            get_values( data, 0, count - count0, channel_idx, values + count0 );
+        if( stats )
+        {
+            stats->NumGetValuesCalls += count0 < count ? 2 : 1;
+            stats->NumValuesFetched += count;
+        }
+    }
+
+    float GetValue( int value_idx, int channel_idx ) const
+    {
+        float v;
+        GetValues( value_idx, 1, channel_idx, &v );
+        return v;
+    }
+
+    // Range of values in [first_idx,end_idx) from get_range(), returns
+    // false if undefined or get_range() fails so that caller scans values
+    bool GetRange( int channel_idx, int first_idx, int end_idx, float& v_min, float& v_max ) const
+    {
+        if( !get_range )
+            return false;
+        int physical_first = first_idx + values_offset;
+        if( physical_first >= num_values )
+            physical_first -= num_values;
+        const int count = end_idx - first_idx;
+        const int count0 = ImMin( count, num_values - physical_first );
+        float min0 = FLT_MAX, max0 = -FLT_MAX, min1 = FLT_MAX, max1 = -FLT_MAX;
+        if( stats )
+            stats->NumGetRangeCalls += count0 < count ? 2 : 1;
+        if( !get_range( range_data, channel_idx, physical_first, count0, &min0, &max0 ) )
+            return false;
+        if( count0 < count && !get_range( range_data, channel_idx, 0, count - count0, &min1, &max1 ) )
+            return false;
+        v_min = ImMin( min0, min1 );
+        v_max = ImMax( max0, max1 );
+        return true;
+    }
+
+    // Calls fn( first_value_idx, values, num_values ) for consecutive
+    // chunks of values in [first_idx,end_idx)
+    template <typename Fn>
+    void ForEachChunk( int channel_idx, int first_idx, int end_idx, Fn& fn ) const
+    {
+        float chunk[cChunkSize];
+        for( int chunk_first=first_idx; chunk_first<end_idx; chunk_first+=cChunkSize )
+        {
+            const int chunk_size = ImMin( (int)cChunkSize, end_idx-chunk_first );
+            GetValues( chunk_first, chunk_size, channel_idx, chunk );
+            fn( chunk_first, (const float*)chunk, chunk_size );
+        }
+    }
+
+    // Calls fn( value_idx, value ) for all values in [first_idx,end_idx)
+    template <typename Fn>
+    void ForEachValue( int channel_idx, int first_idx, int end_idx, Fn& fn ) const
+    {
+        auto chunk_fn = [&fn]( int first_value_idx, const float* values, int num_values )
+            {
+                for( int i=0; i<num_values; i++ )
+                    fn( first_value_idx+i, values[i] );
+            };
+        ForEachChunk( channel_idx, first_idx, end_idx, chunk_fn );
+    }
+};
+
+// Persistent per-widget state, keyed by widget ImGuiID
+// Channel hierarchy from get_channel_parent() as first-child and
+// next-sibling lists, so subtrees can be walked in O(subtree) instead
+// of querying parents of every channel. Channels with an invalid
+// parent are roots, siblings are sorted by channel index.
+struct ChannelHierarchy
+{
+    typedef MultiPlotLines_Params::gcp_fn_t gcp_fn_t;
+    int             NumChannels = -1;
+    const gcp_fn_t* GetParent = nullptr;
+    const void*     Data = nullptr;
+    int             FirstRoot = -1;
+    ImVector<int>   FirstChild;
+    ImVector<int>   NextSibling;
+
+    // Rebuild in O(num_channels) if the hierarchy source changed
+    void Update( int num_channels, const gcp_fn_t* get_parent, const void* data )
+    {
+        if( num_channels == NumChannels && get_parent == GetParent && data == Data )
+            return;
+        NumChannels = num_channels;
+        GetParent = get_parent;
+        Data = data;
+        FirstRoot = -1;
+        FirstChild.resize( num_channels );
+        NextSibling.resize( num_channels );
+        for( int it_channel=0; it_channel<num_channels; it_channel++ )
+            FirstChild[it_channel] = -1;
+        // Prepend in reverse order so siblings end up sorted
+        for( int it_channel=num_channels-1; it_channel>=0; it_channel-- )
+        {
+            const int parent = get_parent ? get_parent( data, it_channel ) : -1;
+            int& first = ( parent >= 0 && parent < num_channels && parent != it_channel )
+                         ? FirstChild[parent]
+                         : FirstRoot;
+            NextSibling[it_channel] = first;
+            first = it_channel;
+        }
+    }
+
+    // Call fn(channel_idx) for all descendants of channel_idx, bounded
+    // to num_channels calls in case get_channel_parent() has cycles
+    template <typename Fn>
+    void ForEachDescendant( int channel_idx, ImVector<int>& scratch_stack, Fn fn ) const
+    {
+        scratch_stack.resize( 0 );
+        for( int it_child = FirstChild[channel_idx]; it_child != -1; it_child = NextSibling[it_child] )
+            scratch_stack.push_back( it_child );
+        for( int it_count=0; !scratch_stack.empty() && it_count<NumChannels; it_count++ )
+        {
+            const int it_channel = scratch_stack.back();
+            scratch_stack.pop_back();
+            fn( it_channel );
+            for( int it_child = FirstChild[it_channel]; it_child != -1; it_child = NextSibling[it_child] )
+                scratch_stack.push_back( it_child );
+        }
+    }
+};
+
+// Max points per AddPolyline() call, bounds the vertices emitted per
+// call well below 16-bit ImDrawIdx limits even for thick AA lines
+enum { cMaxPolylinePoints = 4096 };
+
+// Pixel columns at each side of the mouse tested by hover
+enum { cPickRadius = 1 };
+
+// Drawn sample, as picked by hover
+struct PickSample
+{
+    ImVec2 Pos;
+    int    ValueIdx;
+    float  Value;
+};
+
+// Drawn vertical extent of a channel inside a pixel column, with the
+// samples that define its top and bottom
+struct PickColumn
+{
+    float      YTop, YBottom;
+    PickSample Top, Bottom;
+};
+
+// Consecutive points drawn as a single polyline
+struct PolylineSpan
+{
+    int ChannelIdx;
+    int FirstPoint;
+    int NumPoints;
+};
+
+// Vertices and indices emitted by a single AddPolyline() call
+struct GeometryBatch
+{
+    int NumVertices;
+    int NumIndices;
+};
+
+// Retained channel polylines and their draw geometry. Indices are
+// relative to the first vertex of their batch, so that geometry can be
+// copied at any vertex offset of a later ImDrawList
+struct ChannelGeometry
+{
+    bool                    bPointsValid = false;
+    ImVector<ImVec2>        Points;
+    ImVector<int>           ValueIdxs;  //Per-point, for picking
+    ImVector<float>         Values;     //Per-point, for picking
+    ImVector<PolylineSpan>  Spans;
+    PickColumn              Pick[2*cPickRadius+1];
+    bool                    bVerticesValid = false;
+    ImU32                   Color = 0;
+    float                   Thickness = 0.0f;
+    ImVector<ImDrawVert>    Vertices;
+    ImVector<ImDrawIdx>     Indices;
+    ImVector<GeometryBatch> Batches;
+};
+
+// eL_Lanes rows and vertical range of a channel, all zero if hidden
+struct PlotLane
+{
+    float YTop, YBottom;
+    float ScaleMin, ScaleMax;
+};
+
+// Inputs that retained channel points and vertices depend on, besides
+// per-channel color and thickness
+struct RetainedKey
+{
+    ImU32           DataGeneration = 0;
+    ImVec4          InnerRect = ImVec4(0.0f,0.0f,0.0f,0.0f);
+    float           ScaleMin = 0.0f, ScaleMax = 0.0f;
+    float           FilterAlpha = 0.0f;
+    int             NumValues = 0, ValuesOffset = 0, ViewCount = 0;
+    int             Decimation = 0;
+    ImDrawListFlags DrawListFlags = 0;
+    ImVec2          TexUvWhitePixel = ImVec2(0.0f,0.0f);
+
+    bool operator==( const RetainedKey& other ) const
+    {
+        return DataGeneration == other.DataGeneration
+            && InnerRect.x == other.InnerRect.x && InnerRect.y == other.InnerRect.y
+            && InnerRect.z == other.InnerRect.z && InnerRect.w == other.InnerRect.w
+            && ScaleMin == other.ScaleMin && ScaleMax == other.ScaleMax
+            && FilterAlpha == other.FilterAlpha
+            && NumValues == other.NumValues && ValuesOffset == other.ValuesOffset && ViewCount == other.ViewCount
+            && Decimation == other.Decimation
+            && DrawListFlags == other.DrawListFlags
+            && TexUvWhitePixel.x == other.TexUvWhitePixel.x && TexUvWhitePixel.y == other.TexUvWhitePixel.y;
+    }
+};
+
+struct WidgetState
+{
+    // Per-channel ranges (x=min,y=max) of RangesCount values starting
+    // at physical RangesFirst of RangesNumValues, valid while
+    // RangesGeneration[c] matches a non-zero DataGeneration
+    int               RangesNumValues = 0;
+    int               RangesFirst = 0;
+    int               RangesCount = 0;
+    ImVector<ImVec2>  Ranges;
+    ImVector<ImU32>   RangesGeneration;
+
+    // Legend hierarchy and collapsed eLM_Tree nodes
+    ChannelHierarchy            Hierarchy;
+    MultiPlotLines_ChannelMask  LegendCollapsed;
+    // eLM_Tree rows of expanded nodes, rebuilt per frame
+    ImVector<int>               LegendRowChannels;
+    ImVector<int>               LegendRowDepths;
+    ImVector<int>               ScratchStack;
+
+    // eL_Lanes per-channel lanes, empty for eL_Overlay. Retained
+    // geometry also depends on them
+    ImVector<PlotLane>          Lanes;
+
+    // Retained per-channel geometry, see bRetainGeometry
+    RetainedKey                 Retained;
+    ImVector<ChannelGeometry*>  Geometry;
+
+    // Frame of the last call, -1 once compacted
+    int                         LastFrameUsed = -1;
+
+    ~WidgetState() { ResizeGeometry( 0 ); }
+
+    // Free per-channel buffers, everything is rebuilt on the next call
+    void GcCompact()
+    {
+        ResizeGeometry( 0 );
+        Geometry.clear();
+        Lanes.clear();
+        Ranges.clear();
+        RangesGeneration.clear();
+        Hierarchy.NumChannels = -1;
+        Hierarchy.FirstChild.clear();
+        Hierarchy.NextSibling.clear();
+        LegendRowChannels.clear();
+        LegendRowDepths.clear();
+        ScratchStack.clear();
+        LastFrameUsed = -1;
+    }
+
+    void ResizeGeometry( int num_channels )
+    {
+        for( int it_channel=num_channels; it_channel<Geometry.Size; it_channel++ )
+            IM_DELETE( Geometry[it_channel] );
+        const int old_size = Geometry.Size;
+        Geometry.resize( num_channels );
+        for( int it_channel=old_size; it_channel<num_channels; it_channel++ )
+            Geometry[it_channel] = IM_NEW(ChannelGeometry)();
+    }
+};
+
+// Buffers of widgets not drawn for this many frames are freed
+enum { cGcFrames = 600 };
+
+WidgetState* GetWidgetState( ImGuiID id )
+{
+    static ImPool<WidgetState> s_WidgetStates;
+    static int s_LastGcFrame = -1;
+    // Once per frame, compact states of widgets that are no longer
+    // drawn (ex: dynamic ids), as ImGui does for tables
+    const int frame_count = GImGui->FrameCount;
+    if( frame_count != s_LastGcFrame )
+    {
+        s_LastGcFrame = frame_count;
+        for( int it_state=0; it_state<s_WidgetStates.GetMapSize(); it_state++ )
+            if( WidgetState* state = s_WidgetStates.TryGetMapData( it_state ) )
+                if( state->LastFrameUsed != -1 && frame_count - state->LastFrameUsed > cGcFrames )
+                    state->GcCompact();
+    }
+    WidgetState* state = s_WidgetStates.GetOrAddByKey( id );
+    state->LastFrameUsed = frame_count;
+    return state;
+}
+
+// Iterates over channels in [0,num_channels) not set in the hidden
+// mask, scanning a word of 32 channels at a time
+struct VisibleChannelIterator
+{
+    const MultiPlotLines_ChannelMask& Hidden;
+    int   NumChannels;
+    int   WordIdx;
+    ImU32 VisibleBits; //Remaining visible channels in current word
+    int   ChannelIdx;  //Current channel, == NumChannels when done
+
+    VisibleChannelIterator( const MultiPlotLines_ChannelMask& hidden, int num_channels )
+    : Hidden(hidden), NumChannels(num_channels), WordIdx(-1), VisibleBits(0), ChannelIdx(0) { Next(); }
+    bool IsValid() const { return ChannelIdx < NumChannels; }
+    void Next()
+    {
+        while( VisibleBits == 0 )
+        {
+            if( ++WordIdx << 5 >= NumChannels )
+            {
+                ChannelIdx = NumChannels;
+                return;
+            }
+            VisibleBits = WordIdx < Hidden.Words.Size ? ~Hidden.Words[WordIdx] : 0xFFFFFFFFu;
+            if( (WordIdx+1) << 5 > NumChannels ) //partial last word
+                VisibleBits &= (1u << (NumChannels & 31)) - 1u;
+        }
+        ChannelIdx = (WordIdx << 5) + CountTrailingZeros( VisibleBits );
+        VisibleBits &= VisibleBits - 1u; //clear lowest set bit
+    }
+};
+
+// Default channel names ('C_%02d') and colors, generated on demand for
+// any channel index and cached
+struct DefaultChannelTable
+{
+    ImVector<char>  NameChars;
+    ImVector<int>   NameOffsets;
+    ImVector<ImU32> Colors;
+
+    const char* GetName( int channel_idx ) const { return &NameChars[NameOffsets[channel_idx]]; }
+};
+
+const DefaultChannelTable& GetDefaultChannelTable( int num_channels )
+{
+    // Palette from Vibrant,Muted and Light schemes in https://personal.sron.nl/~pault/
+    static const ImU32 s_Palette[32] = { 0xFFDDAA77,0xFFFFDD99,0xFF998844,0xFF33CCBB,
+                                         0xFF00AAAA,0xFF88DDEE,0xFF6688EE,0xFFBBAAFF,
+                                         0xFF3377EE,0xFF1133CC,0xFF7733EE,0xFF7766CC,
+                                         0xFF552288,0xFF9944AA,0xFF0000EE,0xFF00EE00,
+                                         // Repeated but slightly lighter
+                                         0xFFEECC99,0xFFFFEEBB,0xFFBBAA66,0xFF55DDDD,
+                                         0xFF22CCCC,0xFFAAEEFF,0xFF88AAFF,0xFFDDCCFF,
+                                         0xFF5599FF,0xFF3355DD,0xFF9955FF,0xFF9988DD,
+                                         0xFF7744AA,0xFFBB66CC,0xFF2222FF,0xFF22FF22};
+    static DefaultChannelTable s_Table;
+    for( int it_channel=s_Table.Colors.Size; it_channel<num_channels; it_channel++ )
+    {
+        char name[16];
+        const int length = ImFormatString( name, IM_ARRAYSIZE(name), "C_%02d", it_channel );
+        s_Table.NameOffsets.push_back( s_Table.NameChars.Size );
+        for( int it_char=0; it_char<=length; it_char++ )
+            s_Table.NameChars.push_back( name[it_char] );
+        // Palette first, then spread hues by the golden ratio
+        if( it_channel < IM_ARRAYSIZE(s_Palette) )
+            s_Table.Colors.push_back( s_Palette[it_channel] );
+        else
+        {
+            float r, g, b;
+            ColorConvertHSVtoRGB( fmodf( 0.618034f * it_channel, 1.0f ), (it_channel & 1) ? 0.45f : 0.65f, 0.95f, r, g, b );
+            s_Table.Colors.push_back( IM_COL32( (int)(r*255.0f), (int)(g*255.0f), (int)(b*255.0f), 255 ) );
+        }
+    }
+    return s_Table;
+}
+
+// Per-task scratch buffers, so that tasks can run concurrently
+struct TaskScratch
+{
+    ImDrawListSharedData    SharedData; //Copy of the context one, as ImDrawList::AddPolyline() writes its TempBuffer
+    ImDrawList              DrawList;   //Captures channel geometry, uses SharedData
+    ImVector<ImVec2>        Averages;   //LTTB bucket averages
+    MultiPlotLines_Stats    Stats;      //Fetch counters, merged after tasks complete
+
+    TaskScratch() : DrawList( &SharedData ) {}
+
+    // Copy the current context shared data on the calling thread, as
+    // Scratch outlives contexts, but keep this task's TempBuffer
+    void SetSharedData( const ImDrawListSharedData& shared_data )
+    {
+#if IMGUI_VERSION_NUM >= 18990
+        ImVector<ImVec2> temp_buffer;
+        temp_buffer.swap( SharedData.TempBuffer );
+        SharedData = shared_data;
+        SharedData.TempBuffer.swap( temp_buffer );
+#else
+        SharedData = shared_data;
+#endif
+    }
+};
+
+// Scratch buffers shared by all widgets, reused across calls to avoid allocations
+struct Scratch
+{
+    ImVector<ImVec2>        Points;    //Polyline positions of all visible channels
+    ImVector<PolylineSpan>  Polylines; //Polylines in draw order
+    ImVector<PickColumn>    Pick;      //Pixel columns around the mouse, for the current channel
+    ImVector<ImVec2>        Averages;  //LTTB bucket averages
+    ImVector<int>           Channels;  //Visible channels
+    ImVector<PlotLane>      Lanes;     //eL_Lanes of the current call, swapped into WidgetState::Lanes if changed
+    ImVector<TaskScratch*>  Tasks;
+
+    ~Scratch()
+    {
+        for( int it_task=0; it_task<Tasks.Size; it_task++ )
+            IM_DELETE( Tasks[it_task] );
+    }
+};
+
+Scratch& GetScratch()
+{
+    static Scratch s_Scratch;
+    return s_Scratch;
+}
+
+#if defined(IMGUI_MULTIPLOTLINES_AVX) || defined(IMGUI_MULTIPLOTLINES_SSE2)
+// mask ? a : b, mask lanes are all 0 or all 1 bits
+inline __m128 Select( __m128 mask, __m128 a, __m128 b ) { return _mm_or_ps( _mm_and_ps(mask,a), _mm_andnot_ps(mask,b) ); }
+#endif
+
+// EMA filter of a frame across channels, state is NaN until the first
+// non-NaN value, and NaN values are passed through
+void FilterFrameEMA( const float* in, float* out, float* state, int num_channels, float alpha )
+{
+    int i = 0;
+#if defined(IMGUI_MULTIPLOTLINES_AVX) || defined(IMGUI_MULTIPLOTLINES_SSE2)
+    const __m128 a = _mm_set1_ps( alpha );
+    for( ; i+4 <= num_channels; i+=4 )
+    {
+        const __m128 v = _mm_loadu_ps(in+i);
+        const __m128 f = _mm_loadu_ps(state+i);
+        const __m128 bv = _mm_cmpeq_ps(v,v); //not NaN
+        const __m128 bf = _mm_cmpeq_ps(f,f);
+        const __m128 f1 = Select( bv, Select( bf, _mm_add_ps( f, _mm_mul_ps( a, _mm_sub_ps(v,f) ) ), v ), f );
+        _mm_storeu_ps( state+i, f1 );
+        _mm_storeu_ps( out+i, Select( bv, f1, v ) );
+    }
+#endif
+    for( ; i<num_channels; i++ )
+    {
+        const float v = in[i];
+        if( v == v )
+        {
+            const float f = state[i];
+            state[i] = f == f ? f + alpha*(v-f) : v;
+        }
+        out[i] = v == v ? state[i] : v;
+    }
+}
+
+// Moving average filter of a frame across channels, replacing window
+// value old[] with in[]. sums[] and counts[] only include non-NaN
+// values, and NaN values are passed through
+void FilterFrameMovingAverage( const float* in, float* out, float* old, float* sums, float* counts, int num_channels )
+{
+    int i = 0;
+#if defined(IMGUI_MULTIPLOTLINES_AVX) || defined(IMGUI_MULTIPLOTLINES_SSE2)
+    const __m128 one = _mm_set1_ps( 1.0f );
+    for( ; i+4 <= num_channels; i+=4 )
+    {
+        const __m128 v = _mm_loadu_ps(in+i);
+        const __m128 o = _mm_loadu_ps(old+i);
+        const __m128 bv = _mm_cmpeq_ps(v,v);
+        const __m128 bo = _mm_cmpeq_ps(o,o);
+        const __m128 sum = _mm_add_ps( _mm_sub_ps( _mm_loadu_ps(sums+i), _mm_and_ps(bo,o) ), _mm_and_ps(bv,v) );
+        const __m128 count = _mm_add_ps( _mm_sub_ps( _mm_loadu_ps(counts+i), _mm_and_ps(bo,one) ), _mm_and_ps(bv,one) );
+        _mm_storeu_ps( sums+i, sum );
+        _mm_storeu_ps( counts+i, count );
+        _mm_storeu_ps( old+i, v );
+        _mm_storeu_ps( out+i, Select( bv, _mm_div_ps( sum, count ), v ) );
+    }
+#endif
+    for( ; i<num_channels; i++ )
+    {
+        const float v = in[i];
+        const float o = old[i];
+        if( o == o ) { sums[i] -= o; counts[i] -= 1.0f; }
+        if( v == v ) { sums[i] += v; counts[i] += 1.0f; }
+        old[i] = v;
+        out[i] = v == v ? sums[i] / counts[i] : v;
+    }
+}
+
+// First value_idx in column_idx when num_values are split into num_columns
+inline int ColumnBegin( int column_idx, int num_values, int num_columns )
+{
+    return (int)( (ImS64)column_idx * num_values / num_columns );
+}
+
+// Decimate channel values to a min/max envelope with (at most) 2
+// values per column, calls emit_fn( value_idx, value ) in increasing
+// value_idx order. First and last values are always emitted to
+// preserve the horizontal extent. NaN values are ignored.
+template <typename EmitFn>
+void DecimateMinMax( const ValueSource& src, int channel_idx, int num_values, int num_columns, EmitFn& emit_fn )
+{
+    int last_emitted_idx = 0;
+    emit_fn( 0, src.GetValue(0, channel_idx) );
+    int column_idx = 0;
+    int column_end = ColumnBegin( 1, num_values, num_columns );
+    float v_min = FLT_MAX, v_max = -FLT_MAX;
+    int min_idx = -1, max_idx = -1;
+    auto flush_column_fn = [&]()
+        {
+            if( min_idx != -1 ) //skip all NaN
+            {
+                // Emit in value_idx order, skip already emitted
+                const int idx0 = ImMin(min_idx,max_idx), idx1 = ImMax(min_idx,max_idx);
+                if( idx0 > last_emitted_idx )
+                    emit_fn( idx0, idx0 == min_idx ? v_min : v_max );
+                if( idx1 > idx0 && idx1 > last_emitted_idx )
+                    emit_fn( idx1, idx1 == min_idx ? v_min : v_max );
+                last_emitted_idx = ImMax( last_emitted_idx, idx1 );
+            }
+            v_min = FLT_MAX; v_max = -FLT_MAX;
+            min_idx = -1; max_idx = -1;
+        };
+    auto accumulate_fn = [&]( int value_idx, float v )
+        {
+            while( value_idx >= column_end )
+            {
+                flush_column_fn();
+                column_end = ColumnBegin( ++column_idx + 1, num_values, num_columns );
+            }
+            if( v < v_min ) { v_min = v; min_idx = value_idx; }
+            if( v > v_max ) { v_max = v; max_idx = value_idx; }
+        };
+    src.ForEachValue( channel_idx, 0, num_values, accumulate_fn );
+    flush_column_fn();
+    if( last_emitted_idx < num_values-1 )
+        emit_fn( num_values-1, src.GetValue(num_values-1, channel_idx) );
+}
+
+// Decimate channel values to a min/max envelope using per-column
+// get_range() queries instead of fetching all values, so its cost only
+// depends on the number of columns if get_range() is O(1)/O(log) (ex:
+// MultiPlotLines_MinMaxPyramid). Both min and max are emitted at the
+// column center, ordered to minimize the jump from the previous
+// value. Returns false without emitting anything if get_range() fails.
+template <typename EmitFn>
+bool DecimateMinMaxRanges( const ValueSource& src, int channel_idx, int num_values, int num_columns, EmitFn& emit_fn )
+{
+    float v_min = FLT_MAX, v_max = -FLT_MAX;
+    if( !src.GetRange( channel_idx, 0, ColumnBegin(1, num_values, num_columns), v_min, v_max ) )
+        return false;
+    float last_v = src.GetValue(0, channel_idx);
+    int last_emitted_idx = 0;
+    emit_fn( 0, last_v );
+    for( int it_column=0; it_column<num_columns; it_column++ )
+    {
+        const int first_idx = ColumnBegin( it_column, num_values, num_columns );
+        const int end_idx = ColumnBegin( it_column+1, num_values, num_columns );
+        if( it_column > 0 )
+        {
+            v_min = FLT_MAX; v_max = -FLT_MAX;
+            src.GetRange( channel_idx, first_idx, end_idx, v_min, v_max );
+        }
+        if( v_min > v_max ) //all NaN
+            continue;
+        const int mid_idx = ImMax( (first_idx + end_idx - 1) / 2, last_emitted_idx );
+        const bool bMinFirst = last_v != last_v || ImFabs(last_v - v_min) < ImFabs(last_v - v_max);
+        emit_fn( mid_idx, bMinFirst ? v_min : v_max );
+        last_v = bMinFirst ? v_max : v_min;
+        emit_fn( mid_idx, last_v );
+        last_emitted_idx = mid_idx;
+    }
+    if( last_emitted_idx < num_values-1 )
+        emit_fn( num_values-1, src.GetValue(num_values-1, channel_idx) );
+    return true;
+}
+
+// Decimate channel values using Largest-Triangle-Three-Buckets, emits
+// a single value per bucket (column) that maximizes the triangle area
+// with the previously emitted value and the next bucket average. See
+// "Downsampling Time Series for Visual Representation", S.Steinarsson
+// 2013. NaN values are ignored.
+//
+// Bucket averages are gathered in a first pass, so values are fetched
+// twice, in two sequential passes.
+template <typename EmitFn>
+void DecimateLTTB( const ValueSource& src, int channel_idx, int num_values, int num_columns, EmitFn& emit_fn,
+                   ImVector<ImVec2>& scratch_averages )
+{
+    // Interior values [1,num_values-1) are split into num_columns buckets
+    const int num_inner = num_values - 2;
+    auto bucket_begin_fn = [num_inner,num_columns]( int bucket_idx ) { return 1 + ColumnBegin( bucket_idx, num_inner, num_columns ); };
+
+    // Pass 1: Bucket averages (t,v), last one is the last value
+    const ImVec2 last_tv( float(num_values-1), src.GetValue(num_values-1, channel_idx) );
+    scratch_averages.resize( num_columns+1 );
+    for( int it_bucket=0; it_bucket<=num_columns; it_bucket++ )
+        scratch_averages[it_bucket] = ImVec2(0.0f,0.0f);
+    {
+        int bucket_idx = 0;
+        int bucket_end = bucket_begin_fn(1);
+        int count = 0;
+        auto average_fn = [&]( int value_idx, float v )
+            {
+                while( value_idx >= bucket_end )
+                {
+                    scratch_averages[bucket_idx] = count > 0 ? scratch_averages[bucket_idx] * (1.0f/count) : last_tv;
+                    count = 0;
+                    bucket_end = bucket_begin_fn( ++bucket_idx + 1 );
+                }
+                if( v != v ) // Ignore NaN values
+                    return;
+                scratch_averages[bucket_idx].x += float(value_idx);
+                scratch_averages[bucket_idx].y += v;
+                count++;
+            };
+        src.ForEachValue( channel_idx, 1, num_values-1, average_fn );
+        scratch_averages[bucket_idx] = count > 0 ? scratch_averages[bucket_idx] * (1.0f/count) : last_tv;
+        scratch_averages[num_columns] = last_tv;
+    }
+
+    // Pass 2: Select value in each bucket with largest triangle area
+    int a_idx = 0;
+    float a_v = src.GetValue(0, channel_idx);
+    emit_fn( a_idx, a_v );
+    {
+        int bucket_idx = 0;
+        int bucket_end = bucket_begin_fn(1);
+        float max_area = -1.0f;
+        int max_idx = -1;
+        float max_v = 0.0f;
+        auto flush_bucket_fn = [&]()
+            {
+                if( max_idx != -1 )
+                {
+                    a_idx = max_idx;
+                    a_v = max_v;
+                    emit_fn( a_idx, a_v );
+                }
+                max_area = -1.0f;
+                max_idx = -1;
+            };
+        auto select_fn = [&]( int value_idx, float v )
+            {
+                while( value_idx >= bucket_end )
+                {
+                    flush_bucket_fn();
+                    bucket_end = bucket_begin_fn( ++bucket_idx + 1 );
+                }
+                const ImVec2 avg = scratch_averages[bucket_idx+1];
+                const float ref_v = a_v == a_v ? a_v : avg.y; //NaN first value would make all areas NaN
+                const float area = ImFabs( (float(a_idx) - avg.x)*(v - ref_v) - (float(a_idx) - float(value_idx))*(avg.y - ref_v) );
+                if( area > max_area ) // Also ignores NaN values
+                {
+                    max_area = area;
+                    max_idx = value_idx;
+                    max_v = v;
+                }
+            };
+        src.ForEachValue( channel_idx, 1, num_values-1, select_fn );
+        flush_bucket_fn();
+    }
+    emit_fn( num_values-1, last_tv.y );
+}
+
+// Accumulates time elapsed since Start() into a Stats phase, does
+// nothing if Stats is null
+struct PhaseTimer
+{
+    typedef std::chrono::steady_clock Clock;
+    MultiPlotLines_Stats* Stats;
+    Clock::time_point     StartTime;
+
+    explicit PhaseTimer( MultiPlotLines_Stats* stats ) : Stats(stats) { Start(); }
+    void Start() { if( Stats ) StartTime = Clock::now(); }
+    double ElapsedNs() const { return std::chrono::duration<double,std::nano>( Clock::now() - StartTime ).count(); }
+    void Stop( int phase ) { if( Stats ) Stats->PhaseNs[phase] += ElapsedNs(); }
+};
+
+// Per-call Plot inputs shared by all channels
+struct PlotFrame
+{
+    ValueSource Src;
+    int         NumValues;       //Visible values
+    int         NumColumns;      //Pixel columns
+    int         Decimation;      //Effective decimation mode
+    ImRect      InnerBB;
+    float       ScaleMin, ScaleMax;
+    const PlotLane* Lanes;       //eL_Lanes per-channel rows and ranges, overriding InnerBB.y and ScaleMin/Max, nullptr for eL_Overlay
+    float       FilterAlpha;
+    int         PickFirstColumn; //Pixel columns tested by hover
+    int         NumPickColumns;  //0 if not hovered
+};
+
+void ResetPick( PickColumn* pick, int num_pick_columns )
+{
+    for( int it_pick=0; it_pick<num_pick_columns; it_pick++ )
+    {
+        pick[it_pick].YTop = FLT_MAX;
+        pick[it_pick].YBottom = -FLT_MAX;
+    }
+}
+
+// Accumulate segment s0-s1 into overlapped pick columns
+void PickSegment( const PlotFrame& frame, const PickSample& s0, const PickSample& s1, PickColumn* pick )
+{
+    const float x0 = s0.Pos.x - frame.InnerBB.Min.x;
+    const float x1 = s1.Pos.x - frame.InnerBB.Min.x;
+    const int last_column = ImMin( frame.PickFirstColumn + frame.NumPickColumns - 1, (int)x1 );
+    for( int it_column = ImMax( frame.PickFirstColumn, (int)x0 ); it_column <= last_column; it_column++ )
+    {
+        // Segment y at column bounds
+        const float dx = x1 - x0;
+        const float ya = dx > 0.0f ? ImLerp( s0.Pos.y, s1.Pos.y, ImSaturate( (float(it_column) - x0) / dx ) ) : s0.Pos.y;
+        const float yb = dx > 0.0f ? ImLerp( s0.Pos.y, s1.Pos.y, ImSaturate( (float(it_column+1) - x0) / dx ) ) : s1.Pos.y;
+        PickColumn& column = pick[it_column - frame.PickFirstColumn];
+        const bool b0Top = s0.Pos.y < s1.Pos.y;
+        if( ImMin(ya,yb) < column.YTop )
+        {
+            column.YTop = ImMin(ya,yb);
+            column.Top = b0Top ? s0 : s1;
+        }
+        if( ImMax(ya,yb) > column.YBottom )
+        {
+            column.YBottom = ImMax(ya,yb);
+            column.Bottom = b0Top ? s1 : s0;
+        }
+    }
+}
+
+// Fetch, decimate and filter channel values into polylines through
+// consecutive emitted values, appended to points and spans, and pick
+// them. Emitted values are filtered in value space, before scaling, and
+// NaN values split polylines and restart the filter.
+// value_idxs and values optionally receive per-point samples.
+void PrepareChannel( const PlotFrame& frame, int channel_idx,
+                     ImVector<ImVec2>& points, ImVector<PolylineSpan>& spans,
+                     ImVector<int>* value_idxs, ImVector<float>* values,
+                     PickColumn* pick, ImVector<ImVec2>& scratch_averages )
+{
+    const float t_step = 1.0f/(frame.NumValues-1);
+    const float alpha = frame.FilterAlpha;
+    const PlotLane lane = frame.Lanes
+                          ? frame.Lanes[channel_idx]
+                          : PlotLane{ frame.InnerBB.Min.y, frame.InnerBB.Max.y, frame.ScaleMin, frame.ScaleMax };
+    const ImVec2 lane_min( frame.InnerBB.Min.x, lane.YTop );
+    const ImVec2 lane_max( frame.InnerBB.Max.x, lane.YBottom );
+    const float inv_scale = (lane.ScaleMin == lane.ScaleMax) ? 0.0f : (1.0f / (lane.ScaleMax - lane.ScaleMin));
+
+    int first_point = points.Size;
+    auto flush_fn = [&]()
+        {
+            const int num_points = points.Size - first_point;
+            if( num_points > 1 )
+            {
+                const PolylineSpan span = { channel_idx, first_point, num_points };
+                spans.push_back( span );
+            }
+            else
+            {
+                points.resize( first_point );
+                if( value_idxs )
+                {
+                    value_idxs->resize( first_point );
+                    values->resize( first_point );
+                }
+            }
+            first_point = points.Size;
+        };
+    float fv = 0.0f;
+    PickSample last_sample;
+    auto emit_fn = [&]( int value_idx, float v )
+        {
+            if( v != v ) // NaN gap
+            {
+                flush_fn();
+                return;
+            }
+            const bool bFirst = points.Size == first_point;
+            fv = bFirst ? v : fv + alpha*(v-fv); //filtered
+            const ImVec2 tp = ImVec2( value_idx * t_step, 1.0f - ImSaturate((fv - lane.ScaleMin) * inv_scale) ); //normalized
+            const PickSample sample = { ImLerp(lane_min, lane_max, tp), value_idx, fv };
+            points.push_back( sample.Pos );
+            if( value_idxs )
+            {
+                value_idxs->push_back( value_idx );
+                values->push_back( fv );
+            }
+            if( frame.NumPickColumns > 0 )
+                PickSegment( frame, bFirst ? sample : last_sample, sample, pick );
+            last_sample = sample;
+        };
+    switch( frame.Decimation )
+    {
+    case MultiPlotLines_Params::eD_MinMax:
+        if( !DecimateMinMaxRanges( frame.Src, channel_idx, frame.NumValues, frame.NumColumns, emit_fn ) )
+            DecimateMinMax( frame.Src, channel_idx, frame.NumValues, frame.NumColumns, emit_fn );
+        break;
+    case MultiPlotLines_Params::eD_LTTB: DecimateLTTB( frame.Src, channel_idx, frame.NumValues, frame.NumColumns, emit_fn, scratch_averages ); break;
+    case MultiPlotLines_Params::eD_None:
+    default: frame.Src.ForEachValue( channel_idx, 0, frame.NumValues, emit_fn ); break;
+    }
+    flush_fn();
+}
+
+// Pick retained points, only segments that overlap pick columns are
+// visited, found by bisection as x is non-decreasing
+void PickPoints( const PlotFrame& frame, const ChannelGeometry& geometry, PickColumn* pick )
+{
+    const float pick_x0 = frame.InnerBB.Min.x + float(frame.PickFirstColumn);
+    const float pick_x1 = pick_x0 + float(frame.NumPickColumns);
+    for( int it_span=0; frame.NumPickColumns > 0 && it_span<geometry.Spans.Size; it_span++ )
+    {
+        const PolylineSpan& span = geometry.Spans[it_span];
+        const ImVec2* span_points = geometry.Points.Data + span.FirstPoint;
+        int lo = 0, hi = span.NumPoints-1; //last point with x < pick_x0, or 0
+        while( lo < hi )
+        {
+            const int mid = (lo + hi + 1) / 2;
+            if( span_points[mid].x < pick_x0 )
+                lo = mid;
+            else
+                hi = mid - 1;
+        }
+        for( int it_point=lo+1; it_point<span.NumPoints && span_points[it_point-1].x < pick_x1; it_point++ )
+        {
+            const int point_idx = span.FirstPoint + it_point;
+            const PickSample s0 = { span_points[it_point-1], geometry.ValueIdxs[point_idx-1], geometry.Values[point_idx-1] };
+            const PickSample s1 = { span_points[it_point], geometry.ValueIdxs[point_idx], geometry.Values[point_idx] };
+            PickSegment( frame, s0, s1, pick );
+        }
+    }
+}
+
+// Closest drawn extent to the mouse, ties go to the closest extent center
+struct HoverResult
+{
+    int        ChannelIdx;
+    float      Dist;
+    float      MidDist;
+    PickSample Sample;
+
+    void Test( const PickColumn* pick, int num_pick_columns, float mouse_y, int channel_idx )
+    {
+        for( int it_pick=0; it_pick<num_pick_columns; it_pick++ )
+        {
+            const PickColumn& column = pick[it_pick];
+            if( column.YTop > column.YBottom ) //empty
+                continue;
+            const float dist = ImMax( 0.0f, ImMax( column.YTop - mouse_y, mouse_y - column.YBottom ) );
+            const float mid_dist = ImFabs( 0.5f*(column.YTop + column.YBottom) - mouse_y );
+            if( dist < Dist || (dist == Dist && mid_dist < MidDist) )
+            {
+                ChannelIdx = channel_idx;
+                Dist = dist;
+                MidDist = mid_dist;
+                Sample = ImFabs( column.YTop - mouse_y ) < ImFabs( column.YBottom - mouse_y )
+                         ? column.Top
+                         : column.Bottom;
+            }
+        }
+    }
+};
+
+// Draw span in batches of at most cMaxPolylinePoints
+void AddPolylines( ImDrawList* draw_list, const ImVec2* points, const PolylineSpan& span, ImU32 color, float thickness )
+{
+    // Consecutive batches share a point so that they remain connected
+    for( int it_point=0; it_point < span.NumPoints-1; it_point += cMaxPolylinePoints-1 )
+        draw_list->AddPolyline( points + span.FirstPoint + it_point,
+                                ImMin( (int)cMaxPolylinePoints, span.NumPoints - it_point ),
+                                color, ImDrawFlags_None, thickness );
+}
+
+// Same as AddPolylines() but into a capture_list, whose batches are
+// appended to geometry
+void CapturePolylines( ImDrawList& capture_list, const ImVec2* points, const PolylineSpan& span, ImU32 color, float thickness,
+                       ChannelGeometry& geometry )
+{
+    for( int it_point=0; it_point < span.NumPoints-1; it_point += cMaxPolylinePoints-1 )
+    {
+        // Restart capture_list for each batch, so indices are relative to its first vertex
+        capture_list.VtxBuffer.resize(0);
+        capture_list.IdxBuffer.resize(0);
+        capture_list._VtxCurrentIdx = 0;
+        capture_list.CmdBuffer.back().ElemCount = 0;
+        capture_list.AddPolyline( points + span.FirstPoint + it_point,
+                                  ImMin( (int)cMaxPolylinePoints, span.NumPoints - it_point ),
+                                  color, ImDrawFlags_None, thickness );
+        const GeometryBatch batch = { capture_list.VtxBuffer.Size, capture_list.IdxBuffer.Size };
+        const int vtx_begin = geometry.Vertices.Size;
+        const int idx_begin = geometry.Indices.Size;
+        geometry.Vertices.resize( vtx_begin + batch.NumVertices );
+        geometry.Indices.resize( idx_begin + batch.NumIndices );
+        memcpy( geometry.Vertices.Data + vtx_begin, capture_list.VtxBuffer.Data, batch.NumVertices * sizeof(ImDrawVert) );
+        memcpy( geometry.Indices.Data + idx_begin, capture_list.IdxBuffer.Data, batch.NumIndices * sizeof(ImDrawIdx) );
+        geometry.Batches.push_back( batch );
+    }
+}
+
+// Copy captured geometry into draw_list, offsetting indices
+void ReplayGeometry( ImDrawList* draw_list, const ChannelGeometry& geometry )
+{
+    const ImDrawVert* batch_vertices = geometry.Vertices.Data;
+    const ImDrawIdx* batch_indices = geometry.Indices.Data;
+    for( int it_batch=0; it_batch<geometry.Batches.Size; it_batch++ )
+    {
+        const GeometryBatch& batch = geometry.Batches[it_batch];
+        draw_list->PrimReserve( batch.NumIndices, batch.NumVertices );
+        const unsigned int base_idx = draw_list->_VtxCurrentIdx;
+        memcpy( draw_list->_VtxWritePtr, batch_vertices, batch.NumVertices * sizeof(ImDrawVert) );
+        for( int it_idx=0; it_idx<batch.NumIndices; it_idx++ )
+            draw_list->_IdxWritePtr[it_idx] = (ImDrawIdx)(base_idx + batch_indices[it_idx]);
+        draw_list->_VtxWritePtr += batch.NumVertices;
+        draw_list->_IdxWritePtr += batch.NumIndices;
+        draw_list->_VtxCurrentIdx += batch.NumVertices;
+        batch_vertices += batch.NumVertices;
+        batch_indices += batch.NumIndices;
+    }
+}
+
+// Max tasks per parallel_for() call, visible channels are split in
+// contiguous ranges, one per task
+enum { cMaxChannelTasks = 64 };
+
+// Per-channel work on WidgetState::Geometry, as tasks that only touch
+// their own channels and TaskScratch, so that they can run concurrently.
+// Tasks never allocate, as ImGui::MemAlloc() updates unsynchronized
+// metrics: Reserve*() size every buffer they may grow for the worst
+// case on the calling thread before they run
+struct ChannelTasks
+{
+    const PlotFrame*    Frame;
+    WidgetState*        State;
+    const int*          Channels;    //Visible channels
+    int                 NumChannels;
+    TaskScratch* const* Scratch;
+    int                 NumTasks;
+
+    // Fetch/filter/decimate channels with invalid points, and pick all
+    static void PrepareTask( void* task_data, int task_idx )
+    {
+        const ChannelTasks& tasks = *(const ChannelTasks*)task_data;
+        // Fetches are counted per task, if enabled
+        PlotFrame frame = *tasks.Frame;
+        if( frame.Src.stats )
+            frame.Src.stats = &tasks.Scratch[task_idx]->Stats;
+        const int end = tasks.ChannelsEnd( task_idx );
+        for( int it = tasks.ChannelsBegin( task_idx ); it < end; it++ )
+        {
+            const int it_channel = tasks.Channels[it];
+            ChannelGeometry& geometry = *tasks.State->Geometry[it_channel];
+            ResetPick( geometry.Pick, frame.NumPickColumns );
+            if( geometry.bPointsValid )
+            {
+                PickPoints( frame, geometry, geometry.Pick );
+                continue;
+            }
+            geometry.Points.resize(0);
+            geometry.ValueIdxs.resize(0);
+            geometry.Values.resize(0);
+            geometry.Spans.resize(0);
+            PrepareChannel( frame, it_channel, geometry.Points, geometry.Spans, &geometry.ValueIdxs, &geometry.Values,
+                            geometry.Pick, tasks.Scratch[task_idx]->Averages );
+            geometry.bPointsValid = true;
+            geometry.bVerticesValid = false;
+        }
+    }
+
+    // Generate vertices of channels with invalid vertices
+    static void VerticesTask( void* task_data, int task_idx )
+    {
+        const ChannelTasks& tasks = *(const ChannelTasks*)task_data;
+        const int end = tasks.ChannelsEnd( task_idx );
+        for( int it = tasks.ChannelsBegin( task_idx ); it < end; it++ )
+        {
+            ChannelGeometry& geometry = *tasks.State->Geometry[tasks.Channels[it]];
+            if( geometry.bVerticesValid )
+                continue;
+            geometry.Vertices.resize(0);
+            geometry.Indices.resize(0);
+            geometry.Batches.resize(0);
+            for( int it_span=0; it_span<geometry.Spans.Size; it_span++ )
+                CapturePolylines( tasks.Scratch[task_idx]->DrawList, geometry.Points.Data, geometry.Spans[it_span],
+                                  geometry.Color, geometry.Thickness, geometry );
+            geometry.bVerticesValid = true;
+        }
+    }
+
+    // Buffers grown by PrepareTask(): at most a point per value, or 2
+    // per column plus both ends if decimated, and spans of 2+ points
+    void ReservePrepare() const
+    {
+        const int max_points = Frame->Decimation == MultiPlotLines_Params::eD_None
+                               ? Frame->NumValues
+                               : 2*Frame->NumColumns + 2;
+        for( int it=0; it<NumChannels; it++ )
+        {
+            ChannelGeometry& geometry = *State->Geometry[Channels[it]];
+            if( geometry.bPointsValid )
+                continue;
+            geometry.Points.reserve( max_points );
+            geometry.ValueIdxs.reserve( max_points );
+            geometry.Values.reserve( max_points );
+            geometry.Spans.reserve( max_points/2 + 1 );
+        }
+        for( int it_task=0; it_task<NumTasks; it_task++ )
+            Scratch[it_task]->Averages.reserve( Frame->NumColumns + 1 );
+    }
+
+    // Buffers grown by VerticesTask(): AddPolyline() emits at most 4
+    // vertices per point and 18 indices per segment (thick AA lines),
+    // and uses up to 5 temporary normals/points per point
+    void ReserveVertices() const
+    {
+        for( int it=0; it<NumChannels; it++ )
+        {
+            ChannelGeometry& geometry = *State->Geometry[Channels[it]];
+            if( geometry.bVerticesValid )
+                continue;
+            int num_vertices = 0, num_indices = 0, num_batches = 0;
+            for( int it_span=0; it_span<geometry.Spans.Size; it_span++ )
+                for( int it_point=0; it_point < geometry.Spans[it_span].NumPoints-1; it_point += cMaxPolylinePoints-1 )
+                {
+                    const int batch_points = ImMin( (int)cMaxPolylinePoints, geometry.Spans[it_span].NumPoints - it_point );
+                    num_vertices += 4*batch_points;
+                    num_indices += 18*(batch_points-1);
+                    num_batches++;
+                }
+            geometry.Vertices.reserve( num_vertices );
+            geometry.Indices.reserve( num_indices );
+            geometry.Batches.reserve( num_batches );
+        }
+        for( int it_task=0; it_task<NumTasks; it_task++ )
+        {
+            ImDrawList& capture_list = Scratch[it_task]->DrawList;
+            capture_list.VtxBuffer.reserve( 4*cMaxPolylinePoints );
+            capture_list.IdxBuffer.reserve( 18*(cMaxPolylinePoints-1) );
+#if IMGUI_VERSION_NUM >= 18990
+            Scratch[it_task]->SharedData.TempBuffer.reserve( 5*cMaxPolylinePoints );
+#endif
+        }
+    }
+
+    int ChannelsBegin( int task_idx ) const { return (int)( (long long)task_idx * NumChannels / NumTasks ); }
+    int ChannelsEnd( int task_idx ) const { return ChannelsBegin( task_idx+1 ); }
+};
+
+// Empty buffer per channel, so that value indices stay below 2^31 even
+// if num_channels*num_values doesn't
+void ResetChannelBuffers( ImVector<ImVector<float>*>& buffers, int num_channels )
+{
+    for( int it_channel=0; it_channel<buffers.Size; it_channel++ )
+        IM_DELETE( buffers[it_channel] );
+    buffers.resize( num_channels );
+    for( int it_channel=0; it_channel<num_channels; it_channel++ )
+        buffers[it_channel] = IM_NEW(ImVector<float>)();
+}
+
+} //namespace
+
+// Common implementation, get_values(values_data,...) fetches values and
+// data is passed to params callbacks
+static void MultiPlotLines_Impl( const char* label,
+                                 gvs_fn_t* get_values,
+                                 void* values_data,
+                                 void* data,
+                                 int num_values,
+                                 int num_channels,
+                                 MultiPlotLines_Params* params,
+                                 float scale_min, float scale_max,
+                                 ImVec2 frame_size )
+{
+    // Optional instrumentation, nothing is measured if undefined
+    MultiPlotLines_Stats* stats = params ? params->Stats : nullptr;
+    PhaseTimer total_timer( stats );
+    if( stats )
+    {
+        stats->Clear();
+        stats->NumCalls = 1;
+    }
+
     // Early-out if skipped
     ImGuiWindow* window = GetCurrentWindow();
     if (window->SkipItems)
@@ -44,45 +1231,83 @@ void MultiPlotLines( const char* label,
     // Fix/skip bad inputs
     if( num_values < 2 || num_channels < 1 )
         return;
-    if( num_channels > MultiPlotLines_Params::cMaxChannels )
-        num_channels = MultiPlotLines_Params::cMaxChannels;
 
     //---- Proces params, use defaults for anything undefined
     MultiPlotLines_Params DEFAULT_PARAMS;
     if( !params )
         params = &DEFAULT_PARAMS;
 
-    // channel names
-    static const char* s_Names[MultiPlotLines_Params::cMaxChannels] = { "C_00", "C_01", "C_02", "C_03", "C_04", "C_05", "C_06", "C_07",
-                                                                        "C_08", "C_09", "C_10", "C_11", "C_12", "C_13", "C_14", "C_15",
-                                                                        "C_16", "C_17", "C_18", "C_19", "C_20", "C_21", "C_22", "C_23",
-                                                                        "C_24", "C_25", "C_26", "C_27", "C_28", "C_29", "C_30", "C_31" };
-    auto gcn_fn = params->get_channel_name
-                  ? params->get_channel_name
-                  : []( const void* data, int channel_idx ){ return s_Names[channel_idx%MultiPlotLines_Params::cMaxChannels]; };
-    // channel colors
-    // Palette from Vibrant,Muted and Light schemes in https://personal.sron.nl/~pault/
-    static const ImU32 s_Palette[MultiPlotLines_Params::cMaxChannels] = { 0xFFDDAA77,0xFFFFDD99,0xFF998844,0xFF33CCBB,
-                                                                          0xFF00AAAA,0xFF88DDEE,0xFF6688EE,0xFFBBAAFF,
-                                                                          0xFF3377EE,0xFF1133CC,0xFF7733EE,0xFF7766CC,
-                                                                          0xFF552288,0xFF9944AA,0xFF0000EE,0xFF00EE00,
-                                                                          // Repeated but slightly lighter
-                                                                          0xFFEECC99,0xFFFFEEBB,0xFFBBAA66,0xFF55DDDD,
-                                                                          0xFF22CCCC,0xFFAAEEFF,0xFF88AAFF,0xFFDDCCFF,
-                                                                          0xFF5599FF,0xFF3355DD,0xFF9955FF,0xFF9988DD,
-                                                                          0xFF7744AA,0xFFBB66CC,0xFF2222FF,0xFF22FF22};
-    auto gcc_fn = params->get_channel_color
-                  ? params->get_channel_color
-                  : []( const void* data, int channel_idx ){ return s_Palette[channel_idx%MultiPlotLines_Params::cMaxChannels]; };
-
-    // channel parents
-    auto gcp_fn = params->get_channel_parent
-                  ? params->get_channel_parent
-                  : []( const void* data, int channel_idx ){ return -1; };
+    // values
+    ValueSource src;
+    src.get_values = get_values;
+    src.data = values_data;
+    src.num_values = num_values;
+    src.values_offset = params->ValuesOffset % num_values;
+    if( src.values_offset < 0 )
+        src.values_offset += num_values;
+    src.get_range = params->get_channel_range;
+    src.range_data = data;
+    src.stats = stats;
+
+    // view, optionally zoomed/panned with the mouse
+    const bool bHovered = ItemHoverable(frame_bb, id);
+    if( params->bZoomPanUI && bHovered && inner_bb.Contains(g.IO.MousePos) )
+    {
+        // Prevent window scrolling while zooming/panning
+        SetItemKeyOwner( ImGuiKey_MouseWheelY );
+        SetItemKeyOwner( ImGuiKey_MouseWheelX );
+        const float wheel_zoom = g.IO.KeyShift ? 0.0f : g.IO.MouseWheel;
+        const float wheel_pan = g.IO.MouseWheelH + (g.IO.KeyShift ? g.IO.MouseWheel : 0.0f);
+        const double mouse_t = ImClamp((g.IO.MousePos.x - inner_bb.Min.x) / (inner_bb.Max.x - inner_bb.Min.x), 0.0f, 1.0f);
+        double view_first = params->RW_ViewFirst;
+        double view_count = params->RW_ViewCount > 0 ? params->RW_ViewCount : num_values;
+        if( wheel_zoom != 0.0f ) //zoom around mouse
+        {
+            const double anchor_idx = view_first + mouse_t * (view_count-1);
+            view_count = ImClamp( view_count * pow( 0.8, (double)wheel_zoom ), 2.0, (double)num_values );
+            view_first = anchor_idx - mouse_t * (view_count-1);
+        }
+        if( wheel_pan != 0.0f ) //pan 10% per wheel step
+            view_first -= ImMax( 1.0, 0.1 * view_count ) * wheel_pan;
+        params->RW_ViewCount = (int)(view_count + 0.5);
+        params->RW_ViewFirst = (int)ImClamp( view_first + 0.5, 0.0, (double)(num_values - params->RW_ViewCount) );
+        if( IsMouseDoubleClicked(0) ) //reset to whole range
+        {
+            params->RW_ViewFirst = 0;
+            params->RW_ViewCount = 0;
+        }
+    }
+    const int view_count = params->RW_ViewCount > 0 ? ImClamp( params->RW_ViewCount, 2, num_values ) : num_values;
+    const int view_first = ImClamp( params->RW_ViewFirst, 0, num_values - view_count );
+    // From here on values are fetched relative to the view, so all
+    // passes only process [view_first,view_first+view_count)
+    src.values_offset = (src.values_offset + view_first) % num_values;
+    num_values = view_count;
+
+    // channel names and colors, default ones are generated on demand and cached
+    const DefaultChannelTable& default_channels = GetDefaultChannelTable( num_channels );
+    auto gcn_fn = [params,&default_channels]( const void* data, int channel_idx )
+                  {
+                      return params->get_channel_name
+                             ? params->get_channel_name( data, channel_idx )
+                             : default_channels.GetName( channel_idx );
+                  };
+    auto gcc_fn = [params,&default_channels]( const void* data, int channel_idx )
+                  {
+                      return params->get_channel_color
+                             ? params->get_channel_color( data, channel_idx )
+                             : default_channels.Colors[channel_idx];
+                  };
+
+    // persistent per-widget state
+    WidgetState& state = *GetWidgetState(id);
+
+    // channel parents, cached as child lists
+    state.Hierarchy.Update( num_channels, params->get_channel_parent, data );
 
     // Local lambda to execute MCA on channel_idx in Plot/Legend views
     // channel_idx can be -1 (ex: click outside all channels)
-    auto execute_mca_fn = [data,params,num_channels,gcp_fn]( const int* vec_mca, int button_idx, int channel_idx )
+    auto execute_mca_fn = [params,&state]( const int* vec_mca, int button_idx, int channel_idx )
         {
             switch( vec_mca[button_idx] )
             {
@@ -94,14 +1319,12 @@ void MultiPlotLines( const char* label,
                 break;
             case MultiPlotLines_Params::eMCA_ToggleChannel: // Toggle channel visibility
                 if( channel_idx != -1 )
-                    params->RW_HideChannel[channel_idx] = !params->RW_HideChannel[channel_idx];
+                    params->RW_HideChannel.Toggle( channel_idx );
                 break;
             case MultiPlotLines_Params::eMCA_ToggleChildren: // Toggle whole subhierarchy visibility
                 if( channel_idx != -1 )
-                    for( int it_c=channel_idx+1; it_c<num_channels; it_c++ )
-                        for( int parent = gcp_fn(data,it_c); parent != -1; parent = gcp_fn(data,parent) )
-                            if( parent == channel_idx )
-                                params->RW_HideChannel[it_c] = !params->RW_HideChannel[it_c];
+                    state.Hierarchy.ForEachDescendant( channel_idx, state.ScratchStack,
+                                                       [params]( int it_c ){ params->RW_HideChannel.Toggle( it_c ); } );
                 break;
             case MultiPlotLines_Params::eMCA_None:
             default:
@@ -111,98 +1334,257 @@ void MultiPlotLines( const char* label,
 
     //---- Plots
     // Determine scale from values if not specified
-    if( scale_min == FLT_MAX || scale_max == FLT_MAX )
+    PhaseTimer timer( stats );
+    const bool bAutoScaleMin = scale_min == FLT_MAX;
+    const bool bAutoScaleMax = scale_max == FLT_MAX;
+    if( bAutoScaleMin || bAutoScaleMax )
     {
+        // Per-channel ranges are scanned channel-major and cached
+        // until DataGeneration changes, so hiding/showing channels
+        // only recombines them
+        if( state.RangesNumValues != src.num_values
+            || state.RangesFirst != src.values_offset
+            || state.RangesCount != num_values
+            || state.Ranges.Size != num_channels )
+        {
+            state.RangesNumValues = src.num_values;
+            state.RangesFirst = src.values_offset;
+            state.RangesCount = num_values;
+            state.Ranges.resize( num_channels );
+            state.RangesGeneration.resize( num_channels );
+            for( int it_channel=0; it_channel<num_channels; it_channel++ )
+                state.RangesGeneration[it_channel] = 0;
+        }
         float v_min = FLT_MAX;
         float v_max = -FLT_MAX;
-        for( int i = 0; i < num_values; i++ )
+        for( VisibleChannelIterator it_visible(params->RW_HideChannel,num_channels); it_visible.IsValid(); it_visible.Next() )
         {
-            for( int it_channel=0; it_channel<num_channels; it_channel++ )
-            {
-                if( params->RW_HideChannel[it_channel] )
-                    continue;
-                const float v = get_value(data, i, it_channel);
-                if (v != v) // Ignore NaN values
-                    continue;
-                v_min = ImMin(v_min, v);
-                v_max = ImMax(v_max, v);
+            const int it_channel = it_visible.ChannelIdx;
+            ImVec2& range = state.Ranges[it_channel];
+            const bool bCached = params->DataGeneration != 0 && state.RangesGeneration[it_channel] == params->DataGeneration;
+            if( stats )
+                (bCached ? stats->NumRangeCacheHits : stats->NumRangeCacheMisses)++;
+            if( !bCached )
+            {
+                range = ImVec2( FLT_MAX, -FLT_MAX );
+                if( !src.GetRange( it_channel, 0, num_values, range.x, range.y ) )
+                {
+                    auto scale_fn = [&range]( int, const float* values, int num_values )
+                        {
+                            AccumulateMinMax( values, num_values, range.x, range.y );
+                        };
+                    src.ForEachChunk( it_channel, 0, num_values, scale_fn );
+                }
+                state.RangesGeneration[it_channel] = params->DataGeneration;
             }
+            v_min = ImMin(v_min, range.x);
+            v_max = ImMax(v_max, range.y);
         }
         if (scale_min == FLT_MAX)
             scale_min = v_min;
         if (scale_max == FLT_MAX)
             scale_max = v_max;
     }
+    timer.Stop( MultiPlotLines_Stats::eP_Autoscale );
 
     RenderFrame( frame_bb.Min, frame_bb.Max,
                  GetColorU32(ImGuiCol_WindowBg), //FrameBg is blue, too intrusive
                  true, style.FrameRounding );
 
+    // Whether values were decimated, for the Filter UI
+    bool bDecimated = false;
+
     // Init hovered channel from params, if within range
     int hovered_c_idx = params->RW_HoveredChannelIdx < num_channels
                         ? params->RW_HoveredChannelIdx
                         : -1;
     if( num_values > 1 )
     {
-        int num_lines = num_values - 1;
+        PlotFrame frame;
+        frame.Src = src;
+        frame.NumValues = num_values;
+        frame.InnerBB = inner_bb;
+        frame.ScaleMin = scale_min;
+        frame.ScaleMax = scale_max;
+        frame.Lanes = nullptr;
 
-        // UI/Interaction on hovered channel/slice
-        const bool bHovered = ItemHoverable(frame_bb, id);
-        if( bHovered && inner_bb.Contains(g.IO.MousePos) )
-        {
-            // Reset hovered, forget param value if any
-            hovered_c_idx = -1;
+        // Decimate only if there are enough values per pixel column
+        frame.NumColumns = ImMax( 1, (int)inner_bb.GetWidth() );
+        frame.Decimation = float(num_values) > params->DecimationThreshold * float(frame.NumColumns)
+                           ? params->Decimation
+                           : (int)MultiPlotLines_Params::eD_None;
+        // Filtering emitted values would blend min/max envelopes and
+        // depend on width and zoom, so it only applies to raw values
+        bDecimated = frame.Decimation != MultiPlotLines_Params::eD_None;
+        frame.FilterAlpha = bDecimated ? 1.0f : params->RW_FilterAlpha;
 
-            // mouse t,y \in [0..1)
-            const float mouse_t = ImClamp((g.IO.MousePos.x - inner_bb.Min.x) / (inner_bb.Max.x - inner_bb.Min.x), 0.0f, 0.9999f);
-            const float mouse_y01 = 1.0f - ImClamp((g.IO.MousePos.y - inner_bb.Min.y) / (inner_bb.Max.y - inner_bb.Min.y), 0.0f, 1.0f);
-            const float mouse_v = scale_min + mouse_y01*(scale_max-scale_min);
-            const int hovered_v_idx = (int)(mouse_t * num_lines);
+        // Hover tests the drawn extent of each channel in the pixel
+        // columns around the mouse, so spikes between samples are
+        // pickable and no extra values are fetched
+        const bool bPick = bHovered && inner_bb.Contains(g.IO.MousePos);
+        const ImVec2 mouse_pos = g.IO.MousePos;
+        frame.PickFirstColumn = 0;
+        frame.NumPickColumns = 0;
+        if( bPick ) //MousePos is -FLT_MAX without a mouse, only convert it once inside inner_bb
+        {
+            const int mouse_column = (int)(ImClamp( mouse_pos.x, inner_bb.Min.x, inner_bb.Max.x ) - inner_bb.Min.x);
+            frame.PickFirstColumn = ImMax( 0, mouse_column - cPickRadius );
+            frame.NumPickColumns = ImMin( frame.NumColumns-1, mouse_column + cPickRadius ) - frame.PickFirstColumn + 1;
+        }
+        float hovered_max_distance = 0.1f * inner_bb.GetHeight();
 
-            const float cHoveredMaxDistanceSq = (0.1f * (scale_max - scale_min))*(0.1f * (scale_max - scale_min));
-            float closest_v = 0.0f;
-            float closest_dist_sq = 2.0f * cHoveredMaxDistanceSq;
-            for( int it_channel=0; it_channel<num_channels; it_channel++ )
+        // Lanes stack visible channels top to bottom with equal heights,
+        // each scaled to its own range from the autoscale pass, so that
+        // all lanes share a single ranges/prepare/hover pass. Hover only
+        // tests the channel whose lane contains the mouse
+        Scratch& scratch = GetScratch();
+        scratch.Lanes.resize(0);
+        int lane_c_idx = -1;
+        if( params->Layout == MultiPlotLines_Params::eL_Lanes )
+        {
+            int num_lanes = 0;
+            for( VisibleChannelIterator it_visible(params->RW_HideChannel,num_channels); it_visible.IsValid(); it_visible.Next() )
+                num_lanes++;
+            const float spacing = ImMax( 0.0f, params->LaneSpacing );
+            const float lane_height = num_lanes > 0 ? ImMax( 1.0f, (inner_bb.GetHeight() - spacing*(num_lanes-1)) / num_lanes ) : 0.0f;
+            const float lane_step = num_lanes > 1 ? (inner_bb.GetHeight() - lane_height) / (num_lanes-1) : 0.0f;
+            const PlotLane hidden_lane = { 0.0f, 0.0f, 0.0f, 0.0f };
+            if( num_lanes > 0 )
+                scratch.Lanes.resize( num_channels, hidden_lane );
+            int it_lane = 0;
+            for( VisibleChannelIterator it_visible(params->RW_HideChannel,num_channels); it_visible.IsValid(); it_visible.Next() )
             {
-                if( params->RW_HideChannel[it_channel] )
-                    continue;
-
-                // Min at/around hover point, to prevent 1-frame spikes from being unselectable
-                const float v[3] = { get_value(data, hovered_v_idx > 0 ? hovered_v_idx-1 : hovered_v_idx, it_channel),
-                                     get_value(data, hovered_v_idx, it_channel),
-                                     get_value(data, hovered_v_idx < num_values-2 ? hovered_v_idx+1 : hovered_v_idx, it_channel)};
-                // Dist from centroid
-                const float mid_v( 0.3333f*(v[0]+v[1]+v[2]) );
-                const float mid_d_sq( (mouse_v - mid_v)*(mouse_v - mid_v) );
-                // Dist from samples
-                const float d_sq[3] = { (v[0] - mouse_v)*(v[0] - mouse_v),
-                                        (v[1] - mouse_v)*(v[1] - mouse_v),
-                                        (v[2] - mouse_v)*(v[2] - mouse_v) };
-                const int min_d_idx( d_sq[0] < d_sq[1]
-                                     ? (d_sq[0] < d_sq[2] ? 0 : 2)
-                                     : (d_sq[1] < d_sq[2] ? 1 : 2) );
-                // Choose closest to interval, but save closest value too
-                if( mid_d_sq < closest_dist_sq )
+                const int it_channel = it_visible.ChannelIdx;
+                PlotLane& lane = scratch.Lanes[it_channel];
+                lane.YTop = inner_bb.Min.y + it_lane * lane_step;
+                lane.YBottom = lane.YTop + lane_height;
+                lane.ScaleMin = bAutoScaleMin ? state.Ranges[it_channel].x : scale_min;
+                lane.ScaleMax = bAutoScaleMax ? state.Ranges[it_channel].y : scale_max;
+                if( lane_c_idx == -1 && mouse_pos.y < lane.YBottom + 0.5f*spacing )
+                    lane_c_idx = it_channel;
+                if( it_lane > 0 && spacing > 0.0f )
                 {
-                    hovered_c_idx = it_channel;
-                    closest_v = v[min_d_idx];
-                    closest_dist_sq = mid_d_sq;
+                    const float separator_y = lane.YTop - 0.5f*spacing;
+                    window->DrawList->AddLine( ImVec2(inner_bb.Min.x, separator_y), ImVec2(inner_bb.Max.x, separator_y),
+                                               GetColorU32(ImGuiCol_Border) );
                 }
+                it_lane++;
             }
+            hovered_max_distance = lane_height + spacing;
+        }
+        const bool bLanesChanged = scratch.Lanes.Size != state.Lanes.Size
+                                   || (scratch.Lanes.Size > 0 && memcmp( scratch.Lanes.Data, state.Lanes.Data, scratch.Lanes.size_in_bytes() ) != 0);
+        if( bLanesChanged )
+            state.Lanes.swap( scratch.Lanes );
+        frame.Lanes = state.Lanes.empty() ? nullptr : state.Lanes.Data;
+        auto lane_hovered_fn = [&]( int channel_idx ) { return lane_c_idx == -1 || channel_idx == lane_c_idx; };
+        HoverResult hovered = { -1, hovered_max_distance, FLT_MAX, { ImVec2(0.0f,0.0f), 0, 0.0f } };
 
-            // User-defined hovered value drawing
-            if( hovered_c_idx != -1 )
+        // Retained and parallel modes keep per-channel geometry. Retained
+        // geometry is invalidated as a whole if any shared input changes
+        const bool bRetain = params->bRetainGeometry && params->DataGeneration != 0;
+        const bool bPerChannel = bRetain || params->parallel_for;
+        if( bPerChannel )
+        {
+            RetainedKey key;
+            key.DataGeneration = params->DataGeneration;
+            key.InnerRect = ImVec4( inner_bb.Min.x, inner_bb.Min.y, inner_bb.Max.x, inner_bb.Max.y );
+            key.ScaleMin = scale_min;
+            key.ScaleMax = scale_max;
+            key.FilterAlpha = frame.FilterAlpha;
+            key.NumValues = src.num_values;
+            key.ValuesOffset = src.values_offset;
+            key.ViewCount = num_values;
+            key.Decimation = frame.Decimation;
+            key.DrawListFlags = window->DrawList->Flags;
+            key.TexUvWhitePixel = window->DrawList->_Data->TexUvWhitePixel;
+            if( !bRetain || !(key == state.Retained) || bLanesChanged || state.Geometry.Size != num_channels )
             {
-                if( params->HoveredDrawTooltip )
-                    SetTooltip("%s(%d) %4.4g", gcn_fn( data, hovered_c_idx ), hovered_v_idx, closest_v);
-                if( params->HoveredDrawValue )
-                {
-                    const float inv_scale = (scale_min == scale_max) ? 0.0f : (1.0f / (scale_max - scale_min));
-                    const float closest_y01( (closest_v - scale_min) * inv_scale );
-                    ImVec2 closest_pos = ImLerp(inner_bb.Min, inner_bb.Max, ImVec2(mouse_t,1.0f-closest_y01) );
-                    window->DrawList->AddCircleFilled( closest_pos, 5, gcc_fn(data,hovered_c_idx), 10 );
-                }
+                state.Retained = key;
+                state.ResizeGeometry( num_channels );
+                for( int it_channel=0; it_channel<num_channels; it_channel++ )
+                    state.Geometry[it_channel]->bPointsValid = false;
+            }
+        }
+        else if( !state.Geometry.empty() )
+            state.ResizeGeometry( 0 );
+
+        // Run tasks through parallel_for(), if any
+        auto run_tasks_fn = [params]( MultiPlotLines_Params::pt_fn_t* task, void* task_data, int num_tasks )
+            {
+                if( params->parallel_for && num_tasks > 1 )
+                    params->parallel_for( params->parallel_for_data, num_tasks, task, task_data );
+                else
+                    for( int it_task=0; it_task<num_tasks; it_task++ )
+                        task( task_data, it_task );
+            };
+
+        //-- Prepare: Per-channel polyline points and pick columns
+        //-- Hover: Closest drawn extent in channel order
+        timer.Start();
+        ChannelTasks tasks;
+        if( bPerChannel )
+        {
+            scratch.Channels.resize(0);
+            for( VisibleChannelIterator it_visible(params->RW_HideChannel,num_channels); it_visible.IsValid(); it_visible.Next() )
+                scratch.Channels.push_back( it_visible.ChannelIdx );
+            tasks.Frame = &frame;
+            tasks.State = &state;
+            tasks.Channels = scratch.Channels.Data;
+            tasks.NumChannels = scratch.Channels.Size;
+            tasks.NumTasks = ImMin( scratch.Channels.Size, params->parallel_for ? (int)cMaxChannelTasks : 1 );
+            while( scratch.Tasks.Size < tasks.NumTasks )
+                scratch.Tasks.push_back( IM_NEW(TaskScratch)() );
+            tasks.Scratch = scratch.Tasks.Data;
+            if( stats )
+            {
+                stats->NumVisibleChannels = scratch.Channels.Size;
+                for( int it=0; bRetain && it<scratch.Channels.Size; it++ )
+                    (state.Geometry[scratch.Channels[it]]->bPointsValid ? stats->NumGeometryHits : stats->NumGeometryMisses)++;
+                for( int it_task=0; it_task<tasks.NumTasks; it_task++ )
+                    scratch.Tasks[it_task]->Stats.Clear();
+            }
+            tasks.ReservePrepare();
+            run_tasks_fn( ChannelTasks::PrepareTask, &tasks, tasks.NumTasks );
+            if( stats )
+                for( int it_task=0; it_task<tasks.NumTasks; it_task++ )
+                    stats->Add( scratch.Tasks[it_task]->Stats );
+            timer.Stop( MultiPlotLines_Stats::eP_Prepare );
+            timer.Start();
+            for( int it=0; it<scratch.Channels.Size; it++ )
+                if( lane_hovered_fn( scratch.Channels[it] ) )
+                    hovered.Test( state.Geometry[scratch.Channels[it]]->Pick, frame.NumPickColumns, mouse_pos.y, scratch.Channels[it] );
+        }
+        else
+        {
+            scratch.Points.resize(0);
+            scratch.Polylines.resize(0);
+            scratch.Pick.resize( frame.NumPickColumns );
+            for( VisibleChannelIterator it_visible(params->RW_HideChannel,num_channels); it_visible.IsValid(); it_visible.Next() )
+            {
+                ResetPick( scratch.Pick.Data, frame.NumPickColumns );
+                PrepareChannel( frame, it_visible.ChannelIdx, scratch.Points, scratch.Polylines, nullptr, nullptr,
+                                scratch.Pick.Data, scratch.Averages );
+                if( lane_hovered_fn( it_visible.ChannelIdx ) )
+                    hovered.Test( scratch.Pick.Data, frame.NumPickColumns, mouse_pos.y, it_visible.ChannelIdx );
+                if( stats )
+                    stats->NumVisibleChannels++;
             }
+            timer.Stop( MultiPlotLines_Stats::eP_Prepare );
+            timer.Start();
+        }
+        if( stats && frame.Decimation != MultiPlotLines_Params::eD_None )
+            stats->NumDecimatedChannels = stats->NumVisibleChannels;
+
+        // UI/Interaction on hovered channel/slice
+        if( bPick )
+        {
+            // Replace hovered, forget param value if none
+            hovered_c_idx = hovered.ChannelIdx;
+
+            // User-defined hovered value drawing
+            if( hovered_c_idx != -1 && params->HoveredDrawTooltip )
+                SetTooltip("%s(%d) %4.4g", gcn_fn( data, hovered_c_idx ), view_first + hovered.Sample.ValueIdx, hovered.Sample.Value);
 
             // User-defined mouse actions
             for( int it_mb=0; it_mb<3; it_mb++ )
@@ -211,44 +1593,82 @@ void MultiPlotLines( const char* label,
         }
         // Update hovered (will remain unmodified, if Plot is not currently hovered)
         params->RW_HoveredChannelIdx = hovered_c_idx;
+        timer.Stop( MultiPlotLines_Stats::eP_Hover );
 
-        // Per-channel plot line
-        for( int it_channel=0; it_channel<num_channels; it_channel++ )
+        //-- Emit: Per-channel plot lines
+        timer.Start();
+        const int draw_vtx_begin = window->DrawList->VtxBuffer.Size;
+        const int draw_idx_begin = window->DrawList->IdxBuffer.Size;
+        auto channel_color_fn = [&]( int channel_idx )
+            {
+                return channel_idx == params->RW_SelectedChannelIdx
+                       ? params->SelectedColor
+                       : gcc_fn(data,channel_idx);
+            };
+        auto channel_thickness_fn = [&]( int channel_idx )
+            {
+                // Additive channel + hovered + selected thickness
+                float channel_thickness = params->PlotDrawThickness;
+                if( channel_idx == params->RW_HoveredChannelIdx )
+                    channel_thickness += params->HoveredDrawThickness;
+                if( channel_idx == params->RW_SelectedChannelIdx )
+                    channel_thickness += params->SelectedDrawThickness;
+                return channel_thickness;
+            };
+        if( bPerChannel )
         {
-            if( params->RW_HideChannel[it_channel] )
-                continue;
-
-            const ImU32 channel_color = it_channel == params->RW_SelectedChannelIdx
-                                        ? params->SelectedColor
-                                        : gcc_fn(data,it_channel);
-            // Additive channel + hovered + selected thickness
-            float channel_thickness = params->PlotDrawThickness;
-            if( it_channel == params->RW_HoveredChannelIdx )
-                channel_thickness += params->HoveredDrawThickness;
-            if( it_channel == params->RW_SelectedChannelIdx )
-                channel_thickness += params->SelectedDrawThickness;
-
-            const float t_step = 1.0f/num_lines;
-            const ImVec2 alpha( 1.0f, params->RW_FilterAlpha );
-            const float inv_scale = (scale_min == scale_max) ? 0.0f : (1.0f / (scale_max - scale_min));
-
-            // Draw lines
-            float t0 = 0.0f;
-            float v0 = get_value(data, 0, it_channel);
-            ImVec2 ftp0 = ImVec2( t0, 1.0f - ImSaturate((v0 - scale_min) * inv_scale) );
-            for (int n = 0; n < num_lines; n++)
-            {
-                const float t1 = t0 + t_step;
-                const float v1 = get_value( data, n+1, it_channel );
-                const ImVec2 tp1 = ImVec2( t1, 1.0f - ImSaturate((v1 - scale_min) * inv_scale) ); //normalized
-                const ImVec2 ftp1 = ftp0 + alpha*(tp1-ftp0); //filtered
-                ImVec2 pos0 = ImLerp(inner_bb.Min, inner_bb.Max, ftp0);
-                ImVec2 pos1 = ImLerp(inner_bb.Min, inner_bb.Max, ftp1);
-                window->DrawList->AddLine( pos0, pos1, channel_color, channel_thickness );
-                t0 = t1;
-                ftp0 = ftp1;
+            // Vertices are regenerated if color or thickness changed,
+            // and copied into the DrawList in channel order
+            for( int it=0; it<scratch.Channels.Size; it++ )
+            {
+                const int it_channel = scratch.Channels[it];
+                ChannelGeometry& geometry = *state.Geometry[it_channel];
+                const ImU32 channel_color = channel_color_fn( it_channel );
+                const float channel_thickness = channel_thickness_fn( it_channel );
+                if( geometry.Color != channel_color || geometry.Thickness != channel_thickness )
+                {
+                    geometry.Color = channel_color;
+                    geometry.Thickness = channel_thickness;
+                    geometry.bVerticesValid = false;
+                }
+            }
+            for( int it_task=0; it_task<tasks.NumTasks; it_task++ )
+            {
+                scratch.Tasks[it_task]->SetSharedData( *GetDrawListSharedData() );
+                ImDrawList& capture_list = scratch.Tasks[it_task]->DrawList;
+                capture_list._ResetForNewFrame();
+                capture_list.Flags = window->DrawList->Flags;
+            }
+            tasks.ReserveVertices();
+            run_tasks_fn( ChannelTasks::VerticesTask, &tasks, tasks.NumTasks );
+            for( int it=0; it<scratch.Channels.Size; it++ )
+            {
+                const ChannelGeometry& geometry = *state.Geometry[scratch.Channels[it]];
+                ReplayGeometry( window->DrawList, geometry );
+                for( int it_span=0; stats && it_span<geometry.Spans.Size; it_span++ )
+                    stats->NumSegments += geometry.Spans[it_span].NumPoints - 1;
+            }
+        }
+        else
+        {
+            for( int it_span=0; it_span<scratch.Polylines.Size; it_span++ )
+            {
+                const PolylineSpan& span = scratch.Polylines[it_span];
+                AddPolylines( window->DrawList, scratch.Points.Data, span, channel_color_fn( span.ChannelIdx ), channel_thickness_fn( span.ChannelIdx ) );
+                if( stats )
+                    stats->NumSegments += span.NumPoints - 1;
             }
         }
+
+        // Hovered sample, on top of plot lines
+        if( bPick && hovered_c_idx != -1 && params->HoveredDrawValue )
+            window->DrawList->AddCircleFilled( hovered.Sample.Pos, 5, gcc_fn(data,hovered_c_idx), 10 );
+        if( stats )
+        {
+            stats->NumVertices = window->DrawList->VtxBuffer.Size - draw_vtx_begin;
+            stats->NumIndices = window->DrawList->IdxBuffer.Size - draw_idx_begin;
+        }
+        timer.Stop( MultiPlotLines_Stats::eP_Draw );
     }
 
     // Centered Plot label, if not prefixed with ##
@@ -256,12 +1676,15 @@ void MultiPlotLines( const char* label,
                        frame_bb.Max, label, NULL, NULL, ImVec2(0.5f,0.0f));
 
     //-- Plot/UI
+    timer.Start();
     if( params->bFilterUI )
     {
         ImGui::Text( "Filter" );
         ImGui::SameLine();
         ImGui::SetNextItemWidth(-1.0f); //Control width to avoid leaking right
+        ImGui::BeginDisabled( bDecimated ); //ignored while decimated
         ImGui::SliderFloat( "##FilterAlpha", &params->RW_FilterAlpha, 0.1f, 1.0f );
+        ImGui::EndDisabled();
     }
 
     //---- Legend/UI
@@ -270,69 +1693,661 @@ void MultiPlotLines( const char* label,
         ImGui::Checkbox( "Legend?", &params->RW_ShowLegend );
         ImGui::SameLine();
         if( ImGui::Button("All") )
-            for( int it_channel=0; it_channel<num_channels; it_channel++ )
-                params->RW_HideChannel[it_channel] = false;
+            params->RW_HideChannel.SetAll( num_channels, false );
         ImGui::SameLine();
         if( ImGui::Button("None") )
-            for( int it_channel=0; it_channel<num_channels; it_channel++ )
-                params->RW_HideChannel[it_channel] = true;
+            params->RW_HideChannel.SetAll( num_channels, true );
     }
     if( params->RW_ShowLegend )
     {
-        // Try to use max possible columns minimize height
-        int num_columns( num_channels > params->LegendMaxColumns
-                         ? params->LegendMaxColumns
-                         : num_channels );
-        // Reduce column count if it results in the same height (rows) and a better distribution
-        if( (num_channels % num_columns) != 0 //C is inexact
-            && (num_channels % (num_columns-1)) == 0 //C-1 is exact
-            && (num_channels / (num_columns-1)) <= (num_channels / num_columns + 1) ) //C-1 yields <= rows as C
-            num_columns = num_columns - 1;
+        // Local lambda to draw a channel entry as a "fake checkbox"
+        auto legend_entry_fn = [&]( int it_channel )
+            {
+                const ImU32 channel_color = it_channel == params->RW_SelectedChannelIdx
+                                            ? params->SelectedColor
+                                            : gcc_fn(data,it_channel);
+                bool bHidden = params->RW_HideChannel[it_channel];
+
+                // Setup checkbox colors
+                ImGui::PushStyleColor( ImGuiCol_CheckMark, 0x00000000 ); //Disable check
+                // Bg and Bg hovered use channel color, unless hidden
+                ImGui::PushStyleColor( ImGuiCol_FrameBg, bHidden ? 0x00000000 : channel_color );
+                ImGui::PushStyleColor( ImGuiCol_FrameBgHovered, bHidden ? 0x00000000 : channel_color );
+                ImGui::PushStyleColor( ImGuiCol_FrameBgActive, (channel_color & 0x00FFFFFF) | 0x77000000 ); //semi-transparent
+                // Text+Border
+                ImGui::PushStyleColor( ImGuiCol_Text, channel_color );
+                ImGui::PushStyleColor( ImGuiCol_Border, channel_color );
+                // Scope for 6x ImGui::PushStyleColor()
+                {
+                    // NOTE: We draw a Checkbox but discard its potential
+                    // changes, and instead process clicks as MCA below
+                    ImGui::Checkbox( gcn_fn( data, it_channel ), &bHidden );
+
+                    // If hovered in Legend save for next Plot draw
+                    if( ImGui::IsItemHovered() )
+                        params->RW_HoveredChannelIdx = it_channel;
+
+                    // If hovered in Plot or Legend draw border
+                    if( it_channel == params->RW_HoveredChannelIdx )
+                        ImGui::GetWindowDrawList()->AddRect( ImGui::GetItemRectMin(), ImGui::GetItemRectMax(), channel_color );
+
+                    // Run user-defined mouse actions on "fake checkbox"
+                    for( int it_mb=0; it_mb<3; it_mb++ )
+                        if( ImGui::IsItemClicked(it_mb) )
+                            execute_mca_fn( params->LegendMCA, it_mb, it_channel );
+                }
+                ImGui::PopStyleColor(6);
+            };
+
+        // Rows to display, eLM_Tree flattens expanded nodes in depth-first order
+        const bool bTree = params->LegendMode == MultiPlotLines_Params::eLM_Tree;
+        int num_columns = 1;
+        int num_rows = 0;
+        if( bTree )
+        {
+            const ChannelHierarchy& hierarchy = state.Hierarchy;
+            state.LegendRowChannels.resize( 0 );
+            state.LegendRowDepths.resize( 0 );
+            int depth = 0;
+            state.ScratchStack.resize( 0 ); //ancestors of it_channel
+            for( int it_channel = hierarchy.FirstRoot;
+                 it_channel != -1 && state.LegendRowChannels.Size < num_channels; ) //bounded in case of cycles
+            {
+                state.LegendRowChannels.push_back( it_channel );
+                state.LegendRowDepths.push_back( depth );
+                // Descend into expanded children
+                if( hierarchy.FirstChild[it_channel] != -1 && !state.LegendCollapsed[it_channel] )
+                {
+                    state.ScratchStack.push_back( it_channel );
+                    it_channel = hierarchy.FirstChild[it_channel];
+                    depth++;
+                    continue;
+                }
+                // Otherwise next sibling of closest ancestor that has one
+                while( hierarchy.NextSibling[it_channel] == -1 && !state.ScratchStack.empty() )
+                {
+                    it_channel = state.ScratchStack.back();
+                    state.ScratchStack.pop_back();
+                    depth--;
+                }
+                it_channel = hierarchy.NextSibling[it_channel];
+            }
+            num_rows = state.LegendRowChannels.Size;
+        }
+        else
+        {
+            // Try to use max possible columns minimize height
+            num_columns = num_channels > params->LegendMaxColumns
+                          ? params->LegendMaxColumns
+                          : num_channels;
+            // Reduce column count if it results in the same height (rows) and a better distribution
+            if( (num_channels % num_columns) != 0 //C is inexact
+                && (num_channels % (num_columns-1)) == 0 //C-1 is exact
+                && (num_channels / (num_columns-1)) <= (num_channels / num_columns + 1) ) //C-1 yields <= rows as C
+                num_columns = num_columns - 1;
+            num_rows = (num_channels + num_columns - 1) / num_columns;
+        }
+
+        // Optional scrollable region, skipped without rows (ex: eLM_Tree
+        // without roots) as a 0 height child would fill the window
+        const float row_height = ImGui::GetFrameHeightWithSpacing();
+        const bool bScroll = params->LegendMaxHeight > 0.0f && num_rows > 0;
+        if( bScroll )
+            ImGui::BeginChild( ImHashStr( "##Legend", 0, id ), ImVec2( 0.0f, ImMin( params->LegendMaxHeight, num_rows * row_height ) ) ); //Distinct from the Plot item id
+
+        // Only submit rows inside the visible area
         ImGui::Columns( num_columns );
-        for( int it_channel=0; it_channel<num_channels; it_channel++ )
+        ImGuiListClipper clipper;
+        clipper.Begin( num_rows, row_height );
+        while( clipper.Step() )
+            for( int it_row=clipper.DisplayStart; it_row<clipper.DisplayEnd; it_row++ )
+            {
+                if( bTree )
+                {
+                    const int it_channel = state.LegendRowChannels[it_row];
+                    const float indent = state.LegendRowDepths[it_row] * ImGui::GetTreeNodeToLabelSpacing();
+                    if( indent > 0.0f )
+                        ImGui::Indent( indent );
+                    if( state.Hierarchy.FirstChild[it_channel] != -1 )
+                    {
+                        // Arrow-only node, open state is kept in LegendCollapsed
+                        ImGui::SetNextItemOpen( !state.LegendCollapsed[it_channel], ImGuiCond_Always );
+                        ImGui::PushID( it_channel );
+                        const bool bOpen = ImGui::TreeNodeEx( "##Node", ImGuiTreeNodeFlags_NoTreePushOnOpen );
+                        ImGui::PopID();
+                        state.LegendCollapsed.Set( it_channel, !bOpen );
+                    }
+                    else
+                        ImGui::Dummy( ImVec2( ImGui::GetTreeNodeToLabelSpacing(), 0.0f ) );
+                    ImGui::SameLine();
+                    legend_entry_fn( it_channel );
+                    if( indent > 0.0f )
+                        ImGui::Unindent( indent );
+                }
+                else
+                {
+                    // Consecutive channels are spread horizontally, not vertically
+                    for( int it_column=0; it_column<num_columns; it_column++ )
+                    {
+                        const int it_channel = it_row * num_columns + it_column;
+                        if( it_channel < num_channels )
+                            legend_entry_fn( it_channel );
+                        ImGui::NextColumn();
+                    }
+                }
+            }
+        clipper.End();
+        ImGui::Columns(1);
+
+        if( bScroll )
+            ImGui::EndChild();
+    }
+
+    if( stats )
+    {
+        timer.Stop( MultiPlotLines_Stats::eP_Legend );
+        stats->TotalNs = total_timer.ElapsedNs();
+    }
+}
+
+void MultiPlotLines( const char* label,
+                     float (*get_value)(void* data, int value_idx, int channel_idx),
+                     void* data,
+                     int num_values,
+                     int num_channels,
+                     MultiPlotLines_Params* params,
+                     float scale_min, float scale_max,
+                     ImVec2 frame_size )
+{
+    // Adapt per-value get_value() to chunked get_values()
+    struct PerValue
+    {
+        float (*get_value)(void* data, int value_idx, int channel_idx);
+        void* data;
+    } per_value = { get_value, data };
+    MultiPlotLines_Impl( label,
+                         []( void* data, int first_value_idx, int num_values, int channel_idx, float* values )
+                         {
+                             const PerValue* pv = (const PerValue*)data;
+                             for( int i=0; i<num_values; i++ )
+                                 values[i] = pv->get_value( pv->data, first_value_idx+i, channel_idx );
+                         },
+                         &per_value,
+                         data, num_values, num_channels, params, scale_min, scale_max, frame_size );
+}
+
+void MultiPlotLines( const char* label,
+                     void (*get_values)(void* data, int first_value_idx, int num_values, int channel_idx, float* values),
+                     void* data,
+                     int num_values,
+                     int num_channels,
+                     MultiPlotLines_Params* params,
+                     float scale_min, float scale_max,
+                     ImVec2 frame_size )
+{
+    MultiPlotLines_Impl( label, get_values, data, data, num_values, num_channels, params, scale_min, scale_max, frame_size );
+}
+
+//----------------------------------------------------------------
+// ImGui::MultiPlotLines_Stats
+//----------------------------------------------------------------
+void MultiPlotLines_Stats::Add( const MultiPlotLines_Stats& other, int sign )
+{
+    for( int it_phase=0; it_phase<eP_Count; it_phase++ )
+        PhaseNs[it_phase] += sign * other.PhaseNs[it_phase];
+    TotalNs              += sign * other.TotalNs;
+    NumCalls             += sign * other.NumCalls;
+    NumGetValuesCalls    += sign * other.NumGetValuesCalls;
+    NumValuesFetched     += sign * other.NumValuesFetched;
+    NumGetRangeCalls     += sign * other.NumGetRangeCalls;
+    NumVisibleChannels   += sign * other.NumVisibleChannels;
+    NumDecimatedChannels += sign * other.NumDecimatedChannels;
+    NumSegments          += sign * other.NumSegments;
+    NumVertices          += sign * other.NumVertices;
+    NumIndices           += sign * other.NumIndices;
+    NumRangeCacheHits    += sign * other.NumRangeCacheHits;
+    NumRangeCacheMisses  += sign * other.NumRangeCacheMisses;
+    NumGeometryHits      += sign * other.NumGeometryHits;
+    NumGeometryMisses    += sign * other.NumGeometryMisses;
+}
+
+//----------------------------------------------------------------
+// ImGui::MultiPlotLines_Filter
+//----------------------------------------------------------------
+void MultiPlotLines_Filter::Init( int num_channels )
+{
+    IM_ASSERT( num_channels > 0 );
+    NumChannels = num_channels;
+    NumSlots = (Type == eF_MovingAverage || Type == eF_Median) ? ImClamp( Window, 1, (int)cMaxWindow ) : 0;
+    State.resize( num_channels );
+    Counts.resize( num_channels );
+    History.resize( NumSlots * num_channels );
+    Sorted.resize( Type == eF_Median ? num_channels * NumSlots : 0 );
+    Reset();
+}
+
+void MultiPlotLines_Filter::Reset()
+{
+    HistoryPos = 0;
+    for( int it_channel=0; it_channel<NumChannels; it_channel++ )
+    {
+        State[it_channel] = Type == eF_EMA ? NAN : 0.0f;
+        Counts[it_channel] = 0.0f;
+    }
+    for( int it_value=0; it_value<History.Size; it_value++ )
+        History[it_value] = NAN;
+}
+
+void MultiPlotLines_Filter::Process( const float* frame_values, float* filtered_values )
+{
+    float* old_values = History.Data + HistoryPos * NumChannels;
+    switch( Type )
+    {
+    case eF_EMA:
+        FilterFrameEMA( frame_values, filtered_values, State.Data, NumChannels, Alpha );
+        return;
+    case eF_MovingAverage:
+        FilterFrameMovingAverage( frame_values, filtered_values, old_values, State.Data, Counts.Data, NumChannels );
+        if( ++HistoryPos == NumSlots )
+        {
+            // Recompute sums once per window, so that rounding errors
+            // of incremental updates don't accumulate
+            HistoryPos = 0;
+            for( int it_channel=0; it_channel<NumChannels; it_channel++ )
+                State[it_channel] = 0.0f;
+            for( int it_slot=0; it_slot<NumSlots; it_slot++ )
+                for( int it_channel=0; it_channel<NumChannels; it_channel++ )
+                {
+                    const float v = History[it_slot*NumChannels + it_channel];
+                    State[it_channel] += v == v ? v : 0.0f;
+                }
+        }
+        return;
+    case eF_Median:
+        // Per-channel sorted window, updated by removing the oldest
+        // value and inserting the new one in O(Window)
+        for( int it_channel=0; it_channel<NumChannels; it_channel++ )
+        {
+            const float v = frame_values[it_channel];
+            const float old_v = old_values[it_channel];
+            float* sorted = Sorted.Data + it_channel * NumSlots;
+            int count = (int)Counts[it_channel];
+            if( old_v == old_v )
+            {
+                int it_sorted = 0;
+                while( sorted[it_sorted] != old_v )
+                    it_sorted++;
+                for( count--; it_sorted<count; it_sorted++ )
+                    sorted[it_sorted] = sorted[it_sorted+1];
+            }
+            if( v == v )
+            {
+                int it_sorted = count++;
+                for( ; it_sorted > 0 && sorted[it_sorted-1] > v; it_sorted-- )
+                    sorted[it_sorted] = sorted[it_sorted-1];
+                sorted[it_sorted] = v;
+            }
+            old_values[it_channel] = v;
+            Counts[it_channel] = (float)count;
+            filtered_values[it_channel] = v != v ? v
+                                          : (count & 1) ? sorted[count/2]
+                                          : 0.5f * (sorted[count/2-1] + sorted[count/2]);
+        }
+        if( ++HistoryPos == NumSlots )
+            HistoryPos = 0;
+        return;
+    case eF_None:
+    default:
+        if( filtered_values != frame_values )
+            memcpy( filtered_values, frame_values, NumChannels * sizeof(float) );
+        return;
+    }
+}
+
+//----------------------------------------------------------------
+// ImGui::MultiPlotLines_RingBuffer
+//----------------------------------------------------------------
+MultiPlotLines_RingBuffer::~MultiPlotLines_RingBuffer()
+{
+    ResetChannelBuffers( Values, 0 );
+}
+
+void MultiPlotLines_RingBuffer::Init( int num_channels, int capacity )
+{
+    const int num_blocks = (int)( ((ImS64)capacity + cBlockSize - 1) / cBlockSize );
+    IM_ASSERT( num_channels > 0 && capacity > 0 && (ImS64)num_channels * num_blocks <= 0x7FFFFFFF );
+    NumChannels = num_channels;
+    Capacity = capacity;
+    ResetChannelBuffers( Values, num_channels );
+    for( int it_channel=0; it_channel<num_channels; it_channel++ )
+        Values[it_channel]->resize( capacity );
+    BlockRanges.resize( num_channels * num_blocks );
+    FilteredFrame.resize( num_channels );
+    Filter.Init( num_channels );
+    Clear();
+}
+
+void MultiPlotLines_RingBuffer::Clear()
+{
+    Size = 0;
+    Head = 0;
+    Filter.Reset();
+    if( ++Generation == 0 ) //0 would disable caching
+        Generation = 1;
+}
+
+void MultiPlotLines_RingBuffer::Push( const float* frame_values )
+{
+    // Write at the slot after the newest value, which overwrites the oldest if full
+    int slot = Head + Size;
+    if( slot >= Capacity )
+        slot -= Capacity;
+    const int num_blocks = BlockRanges.Size / NumChannels;
+    const int block_idx = slot / cBlockSize;
+    const bool bNewBlock = (slot % cBlockSize) == 0;
+    if( Filter.Type != MultiPlotLines_Filter::eF_None )
+    {
+        Filter.Process( frame_values, FilteredFrame.Data );
+        frame_values = FilteredFrame.Data;
+    }
+    for( int it_channel=0; it_channel<NumChannels; it_channel++ )
+    {
+        const float v = frame_values[it_channel];
+        Values[it_channel]->Data[slot] = v;
+        ImVec2& block_range = BlockRanges[it_channel*num_blocks + block_idx];
+        if( bNewBlock )
+            block_range = ImVec2( FLT_MAX, -FLT_MAX );
+        block_range.x = v < block_range.x ? v : block_range.x;
+        block_range.y = v > block_range.y ? v : block_range.y;
+    }
+    if( Size < Capacity )
+        Size++;
+    else if( ++Head == Capacity )
+        Head = 0;
+    if( ++Generation == 0 ) //0 would disable caching
+        Generation = 1;
+}
+
+float MultiPlotLines_RingBuffer::GetValue( int value_idx, int channel_idx ) const
+{
+    int slot = Head + value_idx;
+    if( slot >= Capacity )
+        slot -= Capacity;
+    return Values[channel_idx]->Data[slot];
+}
+
+void MultiPlotLines_RingBuffer::GetValues( void* data, int first_value_idx, int num_values, int channel_idx, float* values )
+{
+    const MultiPlotLines_RingBuffer* rb = (const MultiPlotLines_RingBuffer*)data;
+    int slot = rb->Head + first_value_idx;
+    if( slot >= rb->Capacity )
+        slot -= rb->Capacity;
+    const float* channel_values = rb->Values[channel_idx]->Data;
+    const int count0 = ImMin( num_values, rb->Capacity - slot );
+    memcpy( values, channel_values + slot, count0*sizeof(float) );
+    if( count0 < num_values )
+        memcpy( values + count0, channel_values, (num_values-count0)*sizeof(float) );
+}
+
+bool MultiPlotLines_RingBuffer::GetChannelRange( const void* data, int channel_idx, int first_value_idx, int num_values, float* v_min, float* v_max )
+{
+    const MultiPlotLines_RingBuffer* rb = (const MultiPlotLines_RingBuffer*)data;
+    const int num_blocks = rb->BlockRanges.Size / rb->NumChannels;
+    const float* channel_values = rb->Values[channel_idx]->Data;
+    const ImVec2* channel_block_ranges = &rb->BlockRanges[channel_idx*num_blocks];
+    // If full, the block with the next write slot holds both newest
+    // and oldest values but its range only covers the newest ones
+    const int mixed_block_idx = rb->Size == rb->Capacity && (rb->Head % cBlockSize) != 0
+                                ? rb->Head / cBlockSize
+                                : -1;
+    // Combine whole blocks and scan partial ones, in physical slots [begin,end)
+    auto range_fn = [&]( int begin, int end )
+        {
+            int slot = begin;
+            while( slot < end )
+            {
+                const int block_idx = slot / cBlockSize;
+                const int block_begin = block_idx * cBlockSize;
+                const int block_end = ImMin( block_begin + cBlockSize, rb->Capacity );
+                if( slot == block_begin && block_end <= end && block_idx != mixed_block_idx )
+                {
+                    *v_min = ImMin( *v_min, channel_block_ranges[block_idx].x );
+                    *v_max = ImMax( *v_max, channel_block_ranges[block_idx].y );
+                    slot = block_end;
+                }
+                else
+                {
+                    const int scan_end = ImMin( block_end, end );
+                    AccumulateMinMax( channel_values + slot, scan_end - slot, *v_min, *v_max );
+                    slot = scan_end;
+                }
+            }
+        };
+    int slot = rb->Head + first_value_idx;
+    if( slot >= rb->Capacity )
+        slot -= rb->Capacity;
+    const int count0 = ImMin( num_values, rb->Capacity - slot );
+    range_fn( slot, slot + count0 );
+    if( count0 < num_values )
+        range_fn( 0, num_values - count0 );
+    return true;
+}
+
+//----------------------------------------------------------------
+// ImGui::MultiPlotLines_MinMaxPyramid
+//----------------------------------------------------------------
+void MultiPlotLines_MinMaxPyramid::Init( gvs_fn_t* get_values, void* data, int num_channels )
+{
+    IM_ASSERT( get_values != nullptr && num_channels > 0 );
+    SourceGetValues = get_values;
+    SourceData = data;
+    NumChannels = num_channels;
+    NumValues = 0;
+    NumLevels = 0;
+    for( int it_level=0; it_level<cMaxLevels; it_level++ )
+        Levels[it_level].resize(0);
+}
+
+void MultiPlotLines_MinMaxPyramid::Update( int num_values )
+{
+    if( num_values < NumValues ) //rebuild
+    {
+        NumValues = 0;
+        for( int it_level=0; it_level<cMaxLevels; it_level++ )
+            Levels[it_level].resize(0);
+    }
+    if( num_values == NumValues )
+        return;
+
+    // Grow levels, new blocks start empty, until a single block covers all values
+    NumLevels = 0;
+    for( int it_level=0; it_level<cMaxLevels; it_level++ )
+    {
+        const ImS64 block_size = (ImS64)cBaseBlockSize << it_level;
+        const int num_blocks = (int)( (num_values + block_size - 1) / block_size );
+        Levels[it_level].resize( num_blocks * NumChannels, ImVec2(FLT_MAX,-FLT_MAX) );
+        NumLevels = it_level+1;
+        if( num_blocks <= 1 )
+            break;
+    }
+
+    // Level 0: accumulate new values, channel-major, into their blocks
+    // (the first one may be partially filled already)
+    for( int it_channel=0; it_channel<NumChannels; it_channel++ )
+    {
+        ImVec2* level0 = Levels[0].Data;
+        const int num_channels = NumChannels;
+        auto accumulate_fn = [level0,num_channels,it_channel]( int first_value_idx, const float* values, int num_values )
+            {
+                // Split chunk at block boundaries
+                for( int i=0; i<num_values; )
+                {
+                    const int block_idx = (first_value_idx + i) / cBaseBlockSize;
+                    const int count = ImMin( num_values - i, (block_idx+1)*cBaseBlockSize - (first_value_idx + i) );
+                    ImVec2& range = level0[block_idx*num_channels + it_channel];
+                    AccumulateMinMax( values + i, count, range.x, range.y );
+                    i += count;
+                }
+            };
+        ValueSource src;
+        src.get_values = SourceGetValues;
+        src.data = SourceData;
+        src.num_values = num_values;
+        src.values_offset = 0;
+        src.get_range = nullptr;
+        src.range_data = nullptr;
+        src.stats = nullptr;
+        src.ForEachChunk( it_channel, NumValues, num_values, accumulate_fn );
+    }
+
+    // Upper levels: recompute blocks that contain new values from their 2 children
+    for( int it_level=1; it_level<NumLevels; it_level++ )
+    {
+        const ImVector<ImVec2>& children = Levels[it_level-1];
+        ImVector<ImVec2>& parents = Levels[it_level];
+        const int num_children = children.Size / NumChannels;
+        const int num_parents = parents.Size / NumChannels;
+        for( int it_block = (int)(NumValues / ((ImS64)cBaseBlockSize << it_level)); it_block<num_parents; it_block++ )
+        {
+            for( int it_channel=0; it_channel<NumChannels; it_channel++ )
+            {
+                ImVec2 range = children[(2*it_block)*NumChannels + it_channel];
+                if( 2*it_block+1 < num_children )
+                {
+                    const ImVec2& range1 = children[(2*it_block+1)*NumChannels + it_channel];
+                    range.x = ImMin( range.x, range1.x );
+                    range.y = ImMax( range.y, range1.y );
+                }
+                parents[it_block*NumChannels + it_channel] = range;
+            }
+        }
+    }
+    NumValues = num_values;
+}
+
+bool MultiPlotLines_MinMaxPyramid::GetRange( int channel_idx, int first_value_idx, int num_values, float& v_min, float& v_max ) const
+{
+    const int end_value_idx = first_value_idx + num_values;
+    if( first_value_idx < 0 || end_value_idx > NumValues )
+        return false;
+
+    // Scan source values at unaligned edges
+    auto scan_fn = [this,channel_idx,&v_min,&v_max]( int begin, int end )
         {
-            const ImU32 channel_color = it_channel == params->RW_SelectedChannelIdx
-                                        ? params->SelectedColor
-                                        : gcc_fn(data,it_channel);
-
-            // Setup checkbox colors
-            ImGui::PushStyleColor( ImGuiCol_CheckMark, 0x00000000 ); //Disable check
-            // Bg and Bg hovered use channel color, unless hidden
-            ImGui::PushStyleColor( ImGuiCol_FrameBg, params->RW_HideChannel[it_channel] ? 0x00000000 : channel_color );
-            ImGui::PushStyleColor( ImGuiCol_FrameBgHovered, params->RW_HideChannel[it_channel] ? 0x00000000 : channel_color );
-            ImGui::PushStyleColor( ImGuiCol_FrameBgActive, (channel_color & 0x00FFFFFF) | 0x77000000 ); //semi-transparent
-            // Text+Border
-            ImGui::PushStyleColor( ImGuiCol_Text, channel_color );
-            ImGui::PushStyleColor( ImGuiCol_Border, channel_color );
-            // Scope for 6x ImGui::PushStyleColor()
-            {
-                // NOTE: We draw a Checkbox but discard its potential
-                // changes, and instead process clicks as MCA below
-                const bool bTmp = params->RW_HideChannel[it_channel];
-                ImGui::Checkbox( gcn_fn( data, it_channel ), &params->RW_HideChannel[it_channel] );
-                params->RW_HideChannel[it_channel] = bTmp;
-
-                // If hovered in Legend save for next Plot draw
-                if( ImGui::IsItemHovered() )
-                    params->RW_HoveredChannelIdx = it_channel;
-
-                // If hovered in Plot or Legend draw border
-                if( it_channel == params->RW_HoveredChannelIdx )
-                    window->DrawList->AddRect( ImGui::GetItemRectMin(), ImGui::GetItemRectMax(), channel_color );
-
-                // Run user-defined mouse actions on "fake checkbox"
-                for( int it_mb=0; it_mb<3; it_mb++ )
-                    if( ImGui::IsItemClicked(it_mb) )
-                        execute_mca_fn( params->LegendMCA, it_mb, it_channel );
+            float values[cBaseBlockSize];
+            for( int it=begin; it<end; it+=cBaseBlockSize )
+            {
+                const int count = ImMin( (int)cBaseBlockSize, end - it );
+                SourceGetValues( SourceData, it, count, channel_idx, values );
+                AccumulateMinMax( values, count, v_min, v_max );
             }
-            ImGui::PopStyleColor(6);
+        };
+    int lo = (first_value_idx + cBaseBlockSize - 1) / cBaseBlockSize; //first whole block
+    int hi = end_value_idx / cBaseBlockSize; //end of whole blocks
+    if( lo >= hi )
+    {
+        scan_fn( first_value_idx, end_value_idx );
+        return true;
+    }
+    scan_fn( first_value_idx, lo * cBaseBlockSize );
+    scan_fn( hi * cBaseBlockSize, end_value_idx );
 
-            // Move to next column, consecutive channels are spread
-            // horizontally, not vertically
-            ImGui::NextColumn();
+    // Combine whole blocks [lo,hi) bottom-up, using the largest blocks
+    // that fit, as in a segment tree
+    for( int it_level=0; lo<hi && it_level<NumLevels; it_level++ )
+    {
+        const ImVec2* level = Levels[it_level].Data;
+        if( lo & 1 )
+        {
+            const ImVec2& range = level[(lo++)*NumChannels + channel_idx];
+            v_min = ImMin( v_min, range.x );
+            v_max = ImMax( v_max, range.y );
+        }
+        if( hi & 1 )
+        {
+            const ImVec2& range = level[(--hi)*NumChannels + channel_idx];
+            v_min = ImMin( v_min, range.x );
+            v_max = ImMax( v_max, range.y );
+        }
+        lo >>= 1;
+        hi >>= 1;
+    }
+    return true;
+}
+
+void MultiPlotLines_MinMaxPyramid::GetValues( void* data, int first_value_idx, int num_values, int channel_idx, float* values )
+{
+    const MultiPlotLines_MinMaxPyramid* pyramid = (const MultiPlotLines_MinMaxPyramid*)data;
+    pyramid->SourceGetValues( pyramid->SourceData, first_value_idx, num_values, channel_idx, values );
+}
+
+bool MultiPlotLines_MinMaxPyramid::GetChannelRange( const void* data, int channel_idx, int first_value_idx, int num_values, float* v_min, float* v_max )
+{
+    return ((const MultiPlotLines_MinMaxPyramid*)data)->GetRange( channel_idx, first_value_idx, num_values, *v_min, *v_max );
+}
+
+//----------------------------------------------------------------
+// ImGui::MultiPlotLines_FilteredSource
+//----------------------------------------------------------------
+MultiPlotLines_FilteredSource::~MultiPlotLines_FilteredSource()
+{
+    ResetChannelBuffers( Values, 0 );
+}
+
+void MultiPlotLines_FilteredSource::Init( gvs_fn_t* get_values, void* data, int num_channels )
+{
+    IM_ASSERT( get_values != nullptr && num_channels > 0 );
+    SourceGetValues = get_values;
+    SourceData = data;
+    NumChannels = num_channels;
+    NumValues = 0;
+    ResetChannelBuffers( Values, num_channels );
+    Frames.resize( cChunkSize * num_channels );
+    Filter.Init( num_channels );
+}
+
+void MultiPlotLines_FilteredSource::Update( int num_values )
+{
+    if( num_values < NumValues ) //refilter
+    {
+        NumValues = 0;
+        Filter.Reset();
+    }
+    if( num_values == NumValues )
+        return;
+
+    // Channel buffers grow geometrically, keeping filtered values
+    for( int it_channel=0; it_channel<NumChannels; it_channel++ )
+        Values[it_channel]->resize( num_values );
+
+    // Fetch new source values in place, channel-major, then filter them
+    // a frame at a time across channels
+    for( int chunk_first=NumValues; chunk_first<num_values; chunk_first+=cChunkSize )
+    {
+        const int chunk_size = ImMin( (int)cChunkSize, num_values-chunk_first );
+        for( int it_channel=0; it_channel<NumChannels; it_channel++ )
+        {
+            float* channel_values = Values[it_channel]->Data + chunk_first;
+            SourceGetValues( SourceData, chunk_first, chunk_size, it_channel, channel_values );
+            for( int it_value=0; it_value<chunk_size; it_value++ )
+                Frames[it_value*NumChannels + it_channel] = channel_values[it_value];
+        }
+        for( int it_value=0; it_value<chunk_size; it_value++ )
+            Filter.Process( &Frames[it_value*NumChannels], &Frames[it_value*NumChannels] );
+        for( int it_channel=0; it_channel<NumChannels; it_channel++ )
+        {
+            float* channel_values = Values[it_channel]->Data + chunk_first;
+            for( int it_value=0; it_value<chunk_size; it_value++ )
+                channel_values[it_value] = Frames[it_value*NumChannels + it_channel];
         }
-        ImGui::Columns(1);
     }
+    NumValues = num_values;
+}
+
+void MultiPlotLines_FilteredSource::GetValues( void* data, int first_value_idx, int num_values, int channel_idx, float* values )
+{
+    const MultiPlotLines_FilteredSource* filtered = (const MultiPlotLines_FilteredSource*)data;
+    memcpy( values, filtered->Values[channel_idx]->Data + first_value_idx, num_values*sizeof(float) );
 }
 
 } //namespace ImGui
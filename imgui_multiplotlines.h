@@ -12,6 +12,7 @@ namespace ImGui
 // ImGui::MultiPlotLines
 //
 // Plot mutliple channels simultaneously using the same number of values and horizontal/vertical ranges
+// (or as stacked lanes with per-channel vertical ranges, see MultiPlotLines_Params::Layout)
 //
 // Basic usage is similar to ImGui::PlotLines() and only requires:
 // - Providing a get_value() function pointer that accepts and additional channel_idx parameter
@@ -29,6 +30,213 @@ void MultiPlotLines( const char* label,
                      float scale_max = FLT_MAX,
                      ImVec2 graph_size = ImVec2(0, 0) );
 
+// ImGui::MultiPlotLines with bulk value fetching
+//
+// Same as above, but values are requested in contiguous chunks of a
+// single channel: get_values() must write values [first_value_idx,
+// first_value_idx+num_values) of channel channel_idx into values[].
+//
+// Prefer it over per-value get_value() if accessing values is
+// expensive (ex: decompression, locking) as it's called a few times
+// per channel instead of several times per value.
+void MultiPlotLines( const char* label,
+                     void (*get_values)(void* data, int first_value_idx, int num_values, int channel_idx, float* values),
+                     void* data,
+                     int num_values,
+                     int num_channels,
+                     // Default params
+                     struct MultiPlotLines_Params* params = nullptr,
+                     float scale_min = FLT_MAX,
+                     float scale_max = FLT_MAX,
+                     ImVec2 graph_size = ImVec2(0, 0) );
+
+// ImGui::MultiPlotLines_Half
+//
+// IEEE 754 binary16 value stored as raw bits, converted to float on load
+struct MultiPlotLines_Half { ImU16 Bits; };
+
+// Value to float conversion used by MultiPlotLines_View, overload it
+// to support additional types
+template <typename T>
+inline float MultiPlotLines_ToFloat( T v ) { return (float)v; }
+inline float MultiPlotLines_ToFloat( MultiPlotLines_Half h )
+{
+    // Shift exponent+mantissa in place and rebias exponent by 2^(127-15),
+    // also handles subnormals. Inf/NaN keep the max exponent instead.
+    ImU32 bits = (ImU32)(h.Bits & 0x7FFF) << 13;
+    float f;
+    if( (h.Bits & 0x7C00) == 0x7C00 )
+    {
+        bits |= 0x7F800000;
+        memcpy( &f, &bits, sizeof(f) );
+    }
+    else
+    {
+        memcpy( &f, &bits, sizeof(f) );
+        f *= 5.192296858534828e+33f; //2^112
+    }
+    return (h.Bits & 0x8000) ? -f : f;
+}
+
+// ImGui::MultiPlotLines_View<T>
+//
+// Zero-copy typed view of multi-channel values of type T. Value
+// value_idx of channel channel_idx is loaded from
+//   (const char*)Data + value_idx*ValueStride + channel_idx*ChannelStride
+// and converted to Scale*MultiPlotLines_ToFloat(value) + Offset
+//
+// Strides are in bytes, so the view can describe both channel-major
+// (SoA) arrays and interleaved records (AoS). Supported T are float,
+// double, integers (ex: ImS16, ImU16) and MultiPlotLines_Half.
+template <typename T>
+struct MultiPlotLines_View
+{
+    const void* Data          = nullptr;
+    int         ValueStride   = sizeof(T); //Bytes between consecutive values of the same channel
+    int         ChannelStride = 0;         //Bytes between the same value of consecutive channels
+    float       Scale         = 1.0f;
+    float       Offset        = 0.0f;
+
+    // Bulk get_values() specialized for T, loads are inlined in the loop
+    static void GetValues( void* data, int first_value_idx, int num_values, int channel_idx, float* values )
+    {
+        const MultiPlotLines_View* view = (const MultiPlotLines_View*)data;
+        const char* ptr = (const char*)view->Data
+                          + (ImS64)first_value_idx * view->ValueStride
+                          + (ImS64)channel_idx * view->ChannelStride;
+        const float scale = view->Scale;
+        const float offset = view->Offset;
+        if( view->ValueStride == (int)sizeof(T) ) //Contiguous
+        {
+            const T* typed_ptr = (const T*)ptr;
+            for( int i=0; i<num_values; i++ )
+                values[i] = scale * MultiPlotLines_ToFloat( typed_ptr[i] ) + offset;
+        }
+        else //Strided, records may be packed so use unaligned loads
+        {
+            const int stride = view->ValueStride;
+            for( int i=0; i<num_values; i++ )
+            {
+                T v;
+                memcpy( &v, ptr + (ImS64)i*stride, sizeof(T) );
+                values[i] = scale * MultiPlotLines_ToFloat( v ) + offset;
+            }
+        }
+    }
+};
+
+// ImGui::MultiPlotLines with typed views
+//
+// Same as above, but reads values directly from a typed view, without
+// copying them or calling a user function per value. Params callbacks
+// receive a pointer to the view as their data argument.
+template <typename T>
+void MultiPlotLines( const char* label,
+                     const MultiPlotLines_View<T>& view,
+                     int num_values,
+                     int num_channels,
+                     // Default params
+                     struct MultiPlotLines_Params* params = nullptr,
+                     float scale_min = FLT_MAX,
+                     float scale_max = FLT_MAX,
+                     ImVec2 graph_size = ImVec2(0, 0) )
+{
+    MultiPlotLines( label, &MultiPlotLines_View<T>::GetValues, (void*)&view,
+                    num_values, num_channels, params, scale_min, scale_max, graph_size );
+}
+
+// ImGui::MultiPlotLines_ChannelMask
+//
+// Dynamically sized per-channel bitset, packs 32 channels per word.
+// Bits are false by default, including those beyond allocated words.
+struct MultiPlotLines_ChannelMask
+{
+    ImVector<ImU32> Words;
+
+    bool Test( int channel_idx ) const
+    {
+        const int word_idx = channel_idx >> 5;
+        return word_idx < Words.Size && (Words[word_idx] & (1u << (channel_idx & 31))) != 0;
+    }
+    bool operator[]( int channel_idx ) const { return Test( channel_idx ); }
+
+    // Assignable element, so that code written for the former
+    // bool RW_HideChannel[cMaxChannels] array keeps compiling, ex:
+    // params.RW_HideChannel[i] = !params.RW_HideChannel[i]
+    struct Reference
+    {
+        MultiPlotLines_ChannelMask* Mask;
+        int ChannelIdx;
+        Reference( MultiPlotLines_ChannelMask* mask, int channel_idx ) : Mask(mask), ChannelIdx(channel_idx) {}
+        Reference( const Reference& ) = default;
+        operator bool() const { return Mask->Test( ChannelIdx ); }
+        Reference& operator=( bool b ) { Mask->Set( ChannelIdx, b ); return *this; }
+        Reference& operator=( const Reference& other ) { return *this = (bool)other; }
+    };
+    Reference operator[]( int channel_idx ) { return Reference( this, channel_idx ); }
+    void Set( int channel_idx, bool b )
+    {
+        const int word_idx = channel_idx >> 5;
+        if( word_idx >= Words.Size )
+        {
+            if( !b )
+                return;
+            Words.resize( word_idx+1, 0u );
+        }
+        if( b )
+            Words[word_idx] |= 1u << (channel_idx & 31);
+        else
+            Words[word_idx] &= ~(1u << (channel_idx & 31));
+    }
+    void Toggle( int channel_idx ) { Set( channel_idx, !Test( channel_idx ) ); }
+    // Set bits [0,num_channels) to b, a word at a time
+    void SetAll( int num_channels, bool b )
+    {
+        const int num_words = (num_channels + 31) >> 5;
+        if( Words.Size < num_words )
+            Words.resize( num_words, 0u );
+        for( int it_word=0; it_word<num_words; it_word++ )
+        {
+            const ImU32 mask = (it_word < num_channels >> 5) ? 0xFFFFFFFFu : ((1u << (num_channels & 31)) - 1u);
+            Words[it_word] = b ? (Words[it_word] | mask) : (Words[it_word] & ~mask);
+        }
+    }
+};
+
+// ImGui::MultiPlotLines_Stats
+//
+// Optional per-call instrumentation, filled by MultiPlotLines() if
+// MultiPlotLines_Params::Stats is non-null, nothing is measured or
+// counted otherwise. Stats are cleared at the start of each call, use
+// Add() to accumulate them across plots and frames.
+struct MultiPlotLines_Stats
+{
+    enum EPhase { eP_Autoscale, //Channel ranges, if scale_min/max are FLT_MAX
+                  eP_Prepare,   //Fetch, decimate and filter visible channels into polylines
+                  eP_Hover,     //Closest hovered channel (merged into eP_Prepare if not per-channel), tooltip and mouse actions
+                  eP_Draw,      //Plot lines emitted into the window ImDrawList
+                  eP_Legend,    //Filter/Legend UI and Legend
+                  eP_Count };
+    double PhaseNs[eP_Count] = {};
+    double TotalNs           = 0.0;
+    ImS64  NumCalls          = 0; //MultiPlotLines() calls
+    ImS64  NumGetValuesCalls = 0; //Chunked fetches, per-value get_value() is called NumValuesFetched times instead
+    ImS64  NumValuesFetched  = 0;
+    ImS64  NumGetRangeCalls  = 0; //get_channel_range() calls
+    ImS64  NumVisibleChannels   = 0;
+    ImS64  NumDecimatedChannels = 0; //Visible channels drawn with Decimation, see DecimationThreshold
+    ImS64  NumSegments          = 0; //Polyline segments drawn
+    ImS64  NumVertices          = 0; //Emitted into the window ImDrawList by Plot
+    ImS64  NumIndices           = 0;
+    ImS64  NumRangeCacheHits    = 0; //Autoscale channel ranges reused across calls, see DataGeneration
+    ImS64  NumRangeCacheMisses  = 0;
+    ImS64  NumGeometryHits      = 0; //Per-channel points reused across calls, see bRetainGeometry
+    ImS64  NumGeometryMisses    = 0;
+
+    void Clear() { *this = MultiPlotLines_Stats(); }
+    void Add( const MultiPlotLines_Stats& other, int sign = 1 ); //sign = -1 subtracts, ex: for rolling sums
+};
+
 // ImGui::MultiPlotLines_Params struct
 //
 // Pass it to MultiPlotLines() to enable additional functionality,
@@ -40,14 +248,20 @@ void MultiPlotLines( const char* label,
 struct MultiPlotLines_Params
 {
     //---- Channels
-    enum EConstants { cMaxChannels = 32 };
+    enum EConstants { cMaxChannels = 32 }; //OBSOLETE: channels are no longer limited, kept for source compatibility
     typedef const char* gcn_fn_t ( const void* data, int channel_idx );
     typedef ImU32       gcc_fn_t ( const void* data, int channel_idx );
     typedef int         gcp_fn_t ( const void* data, int channel_idx );
+    typedef bool        gcr_fn_t ( const void* data, int channel_idx, int first_value_idx, int num_values, float* v_min, float* v_max );
     const gcn_fn_t* get_channel_name   = nullptr; //if undefined will generate 'C_%d' name
     const gcc_fn_t* get_channel_color  = nullptr; //if undefined will use default Palette[i] color
     const gcp_fn_t* get_channel_parent = nullptr; //if undefined will return -1 (no parent)
-    bool  RW_HideChannel[cMaxChannels] = {};      //All channels are visible by default (hide == false)
+    const gcr_fn_t* get_channel_range  = nullptr; //if undefined, or returns false, will scan values to find their min/max (ignoring NaN)
+    MultiPlotLines_ChannelMask RW_HideChannel;    //All channels are visible by default (hide == false)
+
+    //-- Data
+    ImU32 DataGeneration = 0; //Change it whenever values change to reuse cached per-channel data (ex: ranges) across calls, 0 disables caching
+    int   ValuesOffset   = 0; //Logical value i is fetched from (i+ValuesOffset)%num_values, as in ImGui::PlotLines() values_offset
 
     //-- Hover/Selection
     ImU32 SelectedColor         = 0xFFFFFFFF; //Selected channel(s) use this color (white, not present in default palette)
@@ -61,12 +275,46 @@ struct MultiPlotLines_Params
     bool  HoveredDrawTooltip    = true;  //Draw tooltip for closest hovered channel+value
     bool  HoveredDrawValue      = false; //Draw circle at closest hovered value
     bool  bFilterUI             = false; //Enables additional Filter UI
-    float RW_FilterAlpha        = 1.0f;  //Low pass filter: f_{i+1} = f_i + alpha*(v_{i+1}-f_i), alpha=1.0 means no filtering
+    float RW_FilterAlpha        = 1.0f;  //Low pass filter on drawn values: f_{i+1} = f_i + alpha*(v_{i+1}-f_i), alpha=1.0 means no filtering. Recomputed per call and ignored while values are decimated, see MultiPlotLines_Filter for incremental filtering before decimation
+
+    //-- Layout
+    enum ELayout { eL_Overlay,   //All channels share the plot area and vertical range
+                   eL_Lanes };   //Visible channels are stacked top to bottom in lanes (strip chart), each scaled to its own range unless scale_min/max are specified
+    int   Layout                = eL_Overlay;
+    float LaneSpacing           = 2.0f;  //eL_Lanes: Pixels between consecutive lanes, a separator line is drawn if > 0
+
+    //-- View
+    int   RW_ViewFirst          = 0;     //First visible value
+    int   RW_ViewCount          = 0;     //Number of visible values, 0 means all values
+    bool  bZoomPanUI            = false; //Enables Plot zoom (mouse wheel), pan (Shift+wheel) and reset (double-click)
+
+    //-- Decimation
+    enum EDecimation { eD_None,     //Draw all values, as ImGui::PlotLines() does
+                       eD_MinMax,   //Draw min/max envelope per pixel column, spikes remain visible
+                       eD_LTTB };   //Largest-Triangle-Three-Buckets, one representative value per pixel column
+    int   Decimation            = eD_None; //Decimation mode, draws O(plot width) lines per channel instead of O(num_values)
+    float DecimationThreshold   = 2.0f;    //Only decimate if there are more values than this per pixel column
+
+    //-- Retained geometry
+    bool  bRetainGeometry       = false; //Keep per-channel vertices across calls while DataGeneration (non-zero), frame rect, scale, filter, view, color and thickness are unchanged
+
+    //-- Parallel processing
+    typedef void        pt_fn_t ( void* task_data, int task_idx );
+    typedef void        pf_fn_t ( void* user_data, int num_tasks, pt_fn_t* task, void* task_data );
+    pf_fn_t* parallel_for      = nullptr; //If defined, per-channel work is split in tasks, must call task(task_data,i) for all i in [0,num_tasks), possibly concurrently, and return once all are done. Values/range callbacks must then be thread-safe
+    void*    parallel_for_data = nullptr; //user_data passed to parallel_for()
+
+    //-- Instrumentation
+    MultiPlotLines_Stats* Stats = nullptr; //If defined, filled by each call with phase timings and counters
 
     //-- Legend
-    bool RW_ShowLegend    = false; //RW Enable to display interactive legend
-    bool bLegendUI        = false; //Enables additional Legend UI (Hide/Show Legend and All/None channel visibility)
-    int  LegendMaxColumns = 4;     //Number of columns to use, unless a smaller value results in the same number of rows
+    enum ELegendMode { eLM_Columns,   //Flat column-based layout
+                       eLM_Tree };    //Collapsible hierarchy defined by get_channel_parent()
+    bool  RW_ShowLegend    = false;       //RW Enable to display interactive legend
+    bool  bLegendUI        = false;       //Enables additional Legend UI (Hide/Show Legend and All/None channel visibility)
+    int   LegendMode       = eLM_Columns; //Legend layout, only rows inside the visible area are submitted
+    int   LegendMaxColumns = 4;           //eLM_Columns: Number of columns to use, unless a smaller value results in the same number of rows
+    float LegendMaxHeight  = 0.0f;        //If > 0 Legend is a scrollable region of at most this height
 
     //-- Mouse interaction
     enum EMouseClickAction { eMCA_None,             //Do nothing
@@ -77,6 +325,186 @@ struct MultiPlotLines_Params
     int  LegendMCA[3] = { eMCA_SelectChannel, eMCA_ToggleChannel, eMCA_None };  //Left,Right,Middle buttons
 };
 
+// ImGui::MultiPlotLines_Filter
+//
+// Value-space smoothing filter with per-channel state, advanced a frame
+// (one value per channel) at a time, so streaming sources only filter
+// new values:
+// - eF_EMA: Exponential moving average f_{i+1} = f_i + Alpha*(v_{i+1}-f_i)
+// - eF_MovingAverage: Mean of the last Window values
+// - eF_Median: Median of the last Window values, removes outliers but
+//   keeps steps sharp, and never exceeds the window min/max
+// Windows are trailing, as only past values are known. NaN values are
+// passed through as gaps and leave the state untouched. EMA and moving
+// average kernels run across channels with SIMD.
+//
+// Usage:
+//   filter.Type = ImGui::MultiPlotLines_Filter::eF_Median;
+//   filter.Window = 5;
+//   filter.Init( num_channels );
+//   filter.Process( frame_values, filtered_values ); //for each new frame
+struct MultiPlotLines_Filter
+{
+    enum EType { eF_None,
+                 eF_EMA,
+                 eF_MovingAverage,
+                 eF_Median };
+    enum EConstants { cMaxWindow = 64 };
+
+    int   Type   = eF_None;
+    float Alpha  = 1.0f; //eF_EMA in (0,1], 1.0 means no filtering
+    int   Window = 5;    //eF_MovingAverage and eF_Median values, in [1,cMaxWindow]
+
+    //-- Internal, allocated by Init() for the current Type and Window
+    int   NumChannels = 0;
+    int   NumSlots    = 0;  //Window values kept in History
+    int   HistoryPos  = 0;  //Slot of the oldest value
+    ImVector<float> State;   //[NumChannels] EMA value (NaN until first value) or window sum
+    ImVector<float> Counts;  //[NumChannels] non-NaN values in window
+    ImVector<float> History; //[NumSlots][NumChannels] last input values
+    ImVector<float> Sorted;  //[NumChannels][NumSlots] eF_Median non-NaN window values, sorted
+
+    void Init( int num_channels ); //Call again after changing Type or Window
+    void Reset();
+    void Process( const float* frame_values, float* filtered_values ); //[NumChannels], may be the same array
+};
+
+// ImGui::MultiPlotLines_RingBuffer
+//
+// Multi-channel ring buffer for streaming data (ex: scrolling strip
+// charts) that keeps the last Capacity values of NumChannels channels:
+// - Push() appends a frame with one value per channel in O(NumChannels),
+//   overwriting the oldest frame when full
+// - Values are stored channel-major, so fetched chunks are contiguous
+//   (at most 2 copies if they wrap around)
+// - Per-block min/max and optional Filter state are updated on Push(),
+//   so only new values are processed and ranges never require
+//   rescanning the whole history
+//
+// Usage:
+//   ring.Filter.Type = ImGui::MultiPlotLines_Filter::eF_EMA; //optional, before Init()
+//   ring.Init( num_channels, capacity );
+//   ring.Push( frame_values ); //for each new frame
+//   params.get_channel_range = ImGui::MultiPlotLines_RingBuffer::GetChannelRange;
+//   params.DataGeneration = ring.Generation;
+//   ImGui::MultiPlotLines( label, ImGui::MultiPlotLines_RingBuffer::GetValues, &ring, ring.Size, ring.NumChannels, &params );
+struct MultiPlotLines_RingBuffer
+{
+    enum EConstants { cBlockSize = 64 }; //Values per min/max block
+
+    int   NumChannels = 0;
+    int   Capacity    = 0;
+    int   Size        = 0;    //Number of values per channel, <= Capacity
+    int   Head        = 0;    //Slot of the oldest value
+    ImU32 Generation  = 0;    //Incremented on Push()/Clear(), use as MultiPlotLines_Params::DataGeneration
+    MultiPlotLines_Filter Filter; //Applied on Push(), configure before Init()
+
+    ImVector<ImVector<float>*> Values; //[NumChannels][Capacity], a buffer per channel so that NumChannels*Capacity may exceed 2^31
+    ImVector<ImVec2> BlockRanges;      //[NumChannels][NumBlocks] (x=min,y=max)
+    ImVector<float>  FilteredFrame;    //[NumChannels]
+
+    MultiPlotLines_RingBuffer() {}
+    ~MultiPlotLines_RingBuffer();
+    MultiPlotLines_RingBuffer( const MultiPlotLines_RingBuffer& ) = delete; //Owns Values buffers
+    MultiPlotLines_RingBuffer& operator=( const MultiPlotLines_RingBuffer& ) = delete;
+
+    void Init( int num_channels, int capacity );
+    void Clear();
+    void Push( const float* frame_values ); //frame_values[NumChannels]
+
+    // Value i is the i-th oldest, in [0,Size)
+    float GetValue( int value_idx, int channel_idx ) const;
+
+    // MultiPlotLines() get_values and get_channel_range callbacks, data must point to the MultiPlotLines_RingBuffer
+    static void GetValues( void* data, int first_value_idx, int num_values, int channel_idx, float* values );
+    static bool GetChannelRange( const void* data, int channel_idx, int first_value_idx, int num_values, float* v_min, float* v_max );
+};
+
+// ImGui::MultiPlotLines_MinMaxPyramid
+//
+// Multi-resolution per-channel min/max index over a source of values,
+// for zooming and panning over huge histories at constant cost:
+// - Level 0 blocks span cBaseBlockSize values, each further level
+//   halves the number of blocks
+// - Update() only processes values appended to the source since the
+//   last call, so it can be called every frame for streaming data
+// - GetRange() combines O(log(num_values)) blocks plus up to
+//   2*cBaseBlockSize source values at unaligned edges
+//
+// MultiPlotLines() queries it per pixel column with eD_MinMax
+// decimation, so drawing any view reads O(plot width) pyramid blocks
+// regardless of the number of values.
+//
+// Usage:
+//   pyramid.Init( get_values, data, num_channels ); //raw source
+//   pyramid.Update( num_values ); //whenever the source grows
+//   params.get_channel_range = ImGui::MultiPlotLines_MinMaxPyramid::GetChannelRange;
+//   params.Decimation = ImGui::MultiPlotLines_Params::eD_MinMax;
+//   params.bZoomPanUI = true;
+//   ImGui::MultiPlotLines( label, ImGui::MultiPlotLines_MinMaxPyramid::GetValues, &pyramid, pyramid.NumValues, num_channels, &params );
+struct MultiPlotLines_MinMaxPyramid
+{
+    enum EConstants { cBaseBlockSize = 32, cMaxLevels = 32 };
+    typedef void gvs_fn_t( void* data, int first_value_idx, int num_values, int channel_idx, float* values );
+
+    gvs_fn_t* SourceGetValues = nullptr;
+    void*     SourceData      = nullptr;
+    int       NumChannels     = 0;
+    int       NumValues       = 0; //Values processed by Update()
+    int       NumLevels       = 0;
+    ImVector<ImVec2> Levels[cMaxLevels]; //[level][block][channel] (x=min,y=max)
+
+    void Init( gvs_fn_t* get_values, void* data, int num_channels );
+    void Update( int num_values ); //Processes values appended since last call, rebuilds if num_values decreased
+    bool GetRange( int channel_idx, int first_value_idx, int num_values, float& v_min, float& v_max ) const;
+
+    // MultiPlotLines() get_values and get_channel_range callbacks, data must point to the MultiPlotLines_MinMaxPyramid
+    static void GetValues( void* data, int first_value_idx, int num_values, int channel_idx, float* values );
+    static bool GetChannelRange( const void* data, int channel_idx, int first_value_idx, int num_values, float* v_min, float* v_max );
+};
+
+// ImGui::MultiPlotLines_FilteredSource
+//
+// Filtered copy of a source of values that grows by appending values
+// (ex: a recording in progress), so that smoothing costs O(new values)
+// per frame instead of refiltering the whole history:
+// - Update() only filters values appended to the source since the last
+//   call, in chunks of cChunkSize frames across all channels
+// - Filtered values are stored channel-major, so fetches are contiguous
+//
+// Wrap it in a MultiPlotLines_MinMaxPyramid to autoscale and decimate
+// filtered values in O(plot width) too.
+//
+// Usage:
+//   filtered.Filter.Type = ImGui::MultiPlotLines_Filter::eF_MovingAverage;
+//   filtered.Init( get_values, data, num_channels ); //raw source
+//   filtered.Update( num_values ); //whenever the source grows
+//   ImGui::MultiPlotLines( label, ImGui::MultiPlotLines_FilteredSource::GetValues, &filtered, filtered.NumValues, num_channels, &params );
+struct MultiPlotLines_FilteredSource
+{
+    enum EConstants { cChunkSize = 256 };
+    typedef void gvs_fn_t( void* data, int first_value_idx, int num_values, int channel_idx, float* values );
+
+    MultiPlotLines_Filter Filter; //Configure before Init()
+    gvs_fn_t* SourceGetValues = nullptr;
+    void*     SourceData      = nullptr;
+    int       NumChannels     = 0;
+    int       NumValues       = 0; //Values filtered by Update()
+    ImVector<ImVector<float>*> Values; //[NumChannels][NumValues], a buffer per channel so that NumChannels*NumValues may exceed 2^31
+    ImVector<float> Frames;            //[cChunkSize][NumChannels] frame-major chunk being filtered
+
+    MultiPlotLines_FilteredSource() {}
+    ~MultiPlotLines_FilteredSource();
+    MultiPlotLines_FilteredSource( const MultiPlotLines_FilteredSource& ) = delete; //Owns Values buffers
+    MultiPlotLines_FilteredSource& operator=( const MultiPlotLines_FilteredSource& ) = delete;
+
+    void Init( gvs_fn_t* get_values, void* data, int num_channels );
+    void Update( int num_values ); //Filters values appended since last call, refilters all if num_values decreased
+
+    // MultiPlotLines() get_values callback, data must point to the MultiPlotLines_FilteredSource
+    static void GetValues( void* data, int first_value_idx, int num_values, int channel_idx, float* values );
+};
+
 } //namespace ImGui
 
 #endif //IMGUI_MULTIPLOTLINES
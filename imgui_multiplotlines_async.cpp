@@ -0,0 +1,273 @@
+//----------------------------------------------------------------
+// ImGui::MultiPlotLines_AsyncPipeline
+//----------------------------------------------------------------
+#include "imgui_multiplotlines_async.h"
+#ifndef IMGUI_DEFINE_MATH_OPERATORS
+#define IMGUI_DEFINE_MATH_OPERATORS
+#endif
+#include <imgui/imgui_internal.h>
+#include <math.h> //NAN
+#include <string.h> //memcpy
+#include <chrono>
+
+namespace ImGui
+{
+
+//----------------------------------------------------------------
+// ImGui::MultiPlotLines_AsyncPipeline::Snapshot
+//----------------------------------------------------------------
+void MultiPlotLines_AsyncPipeline::Snapshot::GetValues( void* data, int first_value_idx, int num_values, int channel_idx, float* values )
+{
+    const Snapshot* snapshot = (const Snapshot*)data;
+    memcpy( values, &snapshot->Values[channel_idx*snapshot->NumValues + first_value_idx], num_values*sizeof(float) );
+}
+
+bool MultiPlotLines_AsyncPipeline::Snapshot::GetChannelRange( const void* data, int channel_idx, int first_value_idx, int num_values, float* v_min, float* v_max )
+{
+    const Snapshot* snapshot = (const Snapshot*)data;
+    if( first_value_idx == 0 && num_values == snapshot->NumValues )
+    {
+        const ImVec2& range = snapshot->Ranges[channel_idx];
+        *v_min = range.x < *v_min ? range.x : *v_min;
+        *v_max = range.y > *v_max ? range.y : *v_max;
+        return true;
+    }
+    // Partial views scan at most NumValues, which is O(plot width)
+    const float* channel_values = &snapshot->Values[channel_idx*snapshot->NumValues + first_value_idx];
+    for( int it_value=0; it_value<num_values; it_value++ )
+    {
+        const float v = channel_values[it_value];
+        *v_min = v < *v_min ? v : *v_min; //NaN compares false
+        *v_max = v > *v_max ? v : *v_max;
+    }
+    return true;
+}
+
+//----------------------------------------------------------------
+// ImGui::MultiPlotLines_AsyncPipeline
+//----------------------------------------------------------------
+void MultiPlotLines_AsyncPipeline::Start( int num_channels, int capacity, int queue_frames )
+{
+    IM_ASSERT( num_channels > 0 && capacity > 0 && queue_frames > 0 );
+    Stop();
+    NumChannels = num_channels;
+    // Power of two, so that slots remain contiguous when indices wrap around
+    QueueFrames = 1;
+    while( QueueFrames < queue_frames )
+        QueueFrames *= 2;
+    Queue.resize( QueueFrames * num_channels );
+    QueueHead.store( 0 );
+    QueueTail.store( 0 );
+    NumDropped.store( 0 );
+    RingBuffer.Init( num_channels, capacity );
+    for( int it_snapshot=0; it_snapshot<3; it_snapshot++ )
+    {
+        Snapshots[it_snapshot].Generation = 0;
+        Snapshots[it_snapshot].NumChannels = num_channels;
+        Snapshots[it_snapshot].NumValues = 0;
+        Snapshots[it_snapshot].NumSourceValues = 0;
+    }
+    Front = 0;
+    Middle.store( 1 );
+    Back = 2;
+    bStopRequested.store( false );
+    Worker = std::thread( &MultiPlotLines_AsyncPipeline::WorkerLoop, this );
+}
+
+void MultiPlotLines_AsyncPipeline::Stop()
+{
+    if( !Worker.joinable() )
+        return;
+    bStopRequested.store( true );
+    Worker.join();
+}
+
+bool MultiPlotLines_AsyncPipeline::Push( const float* frame_values )
+{
+    const ImU32 tail = QueueTail.load( std::memory_order_relaxed );
+    if( tail - QueueHead.load( std::memory_order_acquire ) >= (ImU32)QueueFrames )
+    {
+        NumDropped.fetch_add( 1, std::memory_order_relaxed );
+        return false;
+    }
+    memcpy( &Queue[(int)(tail & (ImU32)(QueueFrames-1)) * NumChannels], frame_values, NumChannels*sizeof(float) );
+    QueueTail.store( tail + 1, std::memory_order_release );
+    return true;
+}
+
+const MultiPlotLines_AsyncPipeline::Snapshot* MultiPlotLines_AsyncPipeline::AcquireSnapshot()
+{
+    if( Middle.load( std::memory_order_relaxed ) & cFreshBit )
+        Front = Middle.exchange( Front, std::memory_order_acq_rel ) & cIndexMask;
+    return &Snapshots[Front];
+}
+
+void MultiPlotLines_AsyncPipeline::WorkerLoop()
+{
+    ImU32 generation = 0;
+    int last_num_columns = 0;
+    while( !bStopRequested.load( std::memory_order_relaxed ) )
+    {
+        // Drain pending frames, releasing each slot as soon as it's consumed
+        ImU32 head = QueueHead.load( std::memory_order_relaxed );
+        const ImU32 tail = QueueTail.load( std::memory_order_acquire );
+        const bool bNewFrames = head != tail;
+        for( ; head != tail; head++ )
+        {
+            RingBuffer.Push( &Queue[(int)(head & (ImU32)(QueueFrames-1)) * NumChannels] );
+            QueueHead.store( head + 1, std::memory_order_release );
+        }
+
+        // Publish a new snapshot if anything changed
+        const int num_columns = NumColumns.load( std::memory_order_relaxed );
+        if( !bNewFrames && num_columns == last_num_columns )
+        {
+            std::this_thread::sleep_for( std::chrono::microseconds( IdleSleepUs ) );
+            continue;
+        }
+        last_num_columns = num_columns;
+        Snapshot& snapshot = Snapshots[Back];
+        BuildSnapshot( snapshot, num_columns );
+        if( ++generation == 0 ) //0 would disable caching
+            generation = 1;
+        snapshot.Generation = generation;
+        Back = Middle.exchange( Back | cFreshBit, std::memory_order_acq_rel ) & cIndexMask;
+    }
+}
+
+void MultiPlotLines_AsyncPipeline::BuildSnapshot( Snapshot& snapshot, int num_columns ) const
+{
+    const int num_source_values = RingBuffer.Size;
+    const bool bEnvelope = num_source_values > 2*num_columns;
+    snapshot.NumChannels = NumChannels;
+    snapshot.NumSourceValues = num_source_values;
+    snapshot.NumValues = bEnvelope ? 2*num_columns : num_source_values;
+    snapshot.Values.resize( NumChannels * snapshot.NumValues );
+    snapshot.Ranges.resize( NumChannels );
+    for( int it_channel=0; it_channel<NumChannels; it_channel++ )
+    {
+        float* channel_values = snapshot.Values.Data + it_channel * snapshot.NumValues;
+        ImVec2& range = snapshot.Ranges[it_channel];
+        range = ImVec2( FLT_MAX, -FLT_MAX );
+        if( !bEnvelope )
+        {
+            MultiPlotLines_RingBuffer::GetValues( (void*)&RingBuffer, 0, num_source_values, it_channel, channel_values );
+            MultiPlotLines_RingBuffer::GetChannelRange( &RingBuffer, it_channel, 0, num_source_values, &range.x, &range.y );
+            continue;
+        }
+        // Min/max per column from ring buffer block ranges, ordered so
+        // that the first one is closest to the previous column, as in
+        // eD_MinMax decimation. Columns with only NaN values are NaN
+        float last_v = NAN;
+        for( int it_column=0; it_column<num_columns; it_column++ )
+        {
+            const int first_idx = (int)( (long long)it_column * num_source_values / num_columns );
+            const int end_idx = (int)( (long long)(it_column+1) * num_source_values / num_columns );
+            float v_min = FLT_MAX, v_max = -FLT_MAX;
+            MultiPlotLines_RingBuffer::GetChannelRange( &RingBuffer, it_channel, first_idx, end_idx - first_idx, &v_min, &v_max );
+            if( v_min > v_max )
+            {
+                channel_values[2*it_column] = NAN;
+                channel_values[2*it_column+1] = NAN;
+                continue;
+            }
+            const bool bMinFirst = last_v != last_v || ImFabs(last_v - v_min) < ImFabs(last_v - v_max);
+            channel_values[2*it_column] = bMinFirst ? v_min : v_max;
+            channel_values[2*it_column+1] = last_v = bMinFirst ? v_max : v_min;
+            range.x = ImMin( range.x, v_min );
+            range.y = ImMax( range.y, v_max );
+        }
+    }
+}
+
+//----------------------------------------------------------------
+// ImGui::MultiPlotLines_ThreadPool
+//----------------------------------------------------------------
+void MultiPlotLines_ThreadPool::Start( int num_workers )
+{
+    Stop();
+    if( num_workers <= 0 )
+        num_workers = ImMax( 1, (int)std::thread::hardware_concurrency() - 1 );
+    bStopRequested = false;
+    for( int it_worker=0; it_worker<num_workers; it_worker++ )
+        Workers.push_back( new std::thread( &MultiPlotLines_ThreadPool::WorkerLoop, this ) );
+}
+
+void MultiPlotLines_ThreadPool::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock( Mutex );
+        bStopRequested = true;
+    }
+    WakeUp.notify_all();
+    for( int it_worker=0; it_worker<Workers.Size; it_worker++ )
+    {
+        Workers[it_worker]->join();
+        delete Workers[it_worker];
+    }
+    Workers.clear();
+}
+
+void MultiPlotLines_ThreadPool::ParallelFor( void* data, int num_tasks, pt_fn_t* task, void* task_data )
+{
+    MultiPlotLines_ThreadPool* pool = (MultiPlotLines_ThreadPool*)data;
+    if( pool->Workers.empty() || num_tasks <= 1 )
+    {
+        for( int it_task=0; it_task<num_tasks; it_task++ )
+            task( task_data, it_task );
+        return;
+    }
+    // Open job and wake up workers
+    {
+        std::lock_guard<std::mutex> lock( pool->Mutex );
+        pool->JobTask = task;
+        pool->JobTaskData = task_data;
+        pool->JobNumTasks = num_tasks;
+        pool->JobNextTask.store( 0 );
+        pool->JobDoneTasks.store( 0 );
+        pool->JobGeneration++;
+        pool->bJobOpen = true;
+    }
+    pool->WakeUp.notify_all();
+    // Help, then wait for tasks claimed by workers
+    pool->RunTasks();
+    while( pool->JobDoneTasks.load( std::memory_order_acquire ) < num_tasks )
+        std::this_thread::yield();
+    // Close job so that late workers don't join it, and wait for
+    // joined ones to leave before the job can be reused
+    {
+        std::lock_guard<std::mutex> lock( pool->Mutex );
+        pool->bJobOpen = false;
+    }
+    while( pool->JobActiveWorkers.load( std::memory_order_acquire ) > 0 )
+        std::this_thread::yield();
+}
+
+void MultiPlotLines_ThreadPool::WorkerLoop()
+{
+    ImU32 last_generation = 0;
+    for(;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock( Mutex );
+            WakeUp.wait( lock, [&]{ return bStopRequested || (bJobOpen && JobGeneration != last_generation); } );
+            if( bStopRequested )
+                return;
+            last_generation = JobGeneration;
+            JobActiveWorkers.fetch_add( 1 );
+        }
+        RunTasks();
+        JobActiveWorkers.fetch_sub( 1, std::memory_order_release );
+    }
+}
+
+void MultiPlotLines_ThreadPool::RunTasks()
+{
+    for( int task_idx = JobNextTask.fetch_add( 1 ); task_idx < JobNumTasks; task_idx = JobNextTask.fetch_add( 1 ) )
+    {
+        JobTask( JobTaskData, task_idx );
+        JobDoneTasks.fetch_add( 1, std::memory_order_release );
+    }
+}
+
+} //namespace ImGui
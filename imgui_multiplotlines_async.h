@@ -0,0 +1,160 @@
+//----------------------------------------------------------------
+// ImGui::MultiPlotLines_AsyncPipeline
+//----------------------------------------------------------------
+#ifndef IMGUI_MULTIPLOTLINES_ASYNC
+#define IMGUI_MULTIPLOTLINES_ASYNC
+
+#include "imgui_multiplotlines.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace ImGui
+{
+
+// ImGui::MultiPlotLines_AsyncPipeline
+//
+// Optional background preprocessing for streaming data, so that the UI
+// thread neither locks nor copies producer data, and only draws
+// O(plot width) ready-made values per channel:
+// - A producer thread Push()es frames into a lock-free single-producer
+//   single-consumer queue
+// - A worker thread drains the queue into a MultiPlotLines_RingBuffer
+//   and builds a Snapshot with per-channel min/max envelopes (a pair
+//   of values per column) and ranges
+// - Snapshots are handed to the UI thread through a lock-free triple
+//   buffer, AcquireSnapshot() returns the latest published one
+//
+// Push() must only be called from a single producer thread at a time,
+// and SetNumColumns()/AcquireSnapshot() from a single UI thread.
+//
+// Usage:
+//   pipeline.Start( num_channels, capacity );
+//   pipeline.Push( frame_values ); //producer thread, for each new frame
+//   const ImGui::MultiPlotLines_AsyncPipeline::Snapshot* snapshot = pipeline.AcquireSnapshot(); //UI thread
+//   pipeline.SetNumColumns( (int)width );
+//   params.get_channel_range = ImGui::MultiPlotLines_AsyncPipeline::Snapshot::GetChannelRange;
+//   params.DataGeneration = snapshot->Generation;
+//   ImGui::MultiPlotLines( label, ImGui::MultiPlotLines_AsyncPipeline::Snapshot::GetValues, (void*)snapshot,
+//                          snapshot->NumValues, snapshot->NumChannels, &params, FLT_MAX, FLT_MAX, ImVec2(width,height) );
+struct MultiPlotLines_AsyncPipeline
+{
+    // Ready-to-draw values, owned by the UI thread between
+    // AcquireSnapshot() calls
+    struct Snapshot
+    {
+        ImU32            Generation      = 0; //Non-zero once published, use as MultiPlotLines_Params::DataGeneration
+        int              NumChannels     = 0;
+        int              NumValues       = 0; //Values per channel, raw values or min/max pairs per column if there are more than 2 per column
+        int              NumSourceValues = 0; //Ring buffer values summarized by NumValues
+        ImVector<float>  Values;              //[NumChannels][NumValues]
+        ImVector<ImVec2> Ranges;              //[NumChannels] (x=min,y=max) of all NumValues, ignoring NaN
+
+        // MultiPlotLines() get_values and get_channel_range callbacks, data must point to the Snapshot
+        static void GetValues( void* data, int first_value_idx, int num_values, int channel_idx, float* values );
+        static bool GetChannelRange( const void* data, int channel_idx, int first_value_idx, int num_values, float* v_min, float* v_max );
+    };
+
+    enum EConstants { cDefaultNumColumns = 1024 };
+
+    MultiPlotLines_AsyncPipeline() {}
+    ~MultiPlotLines_AsyncPipeline() { Stop(); }
+
+    // Start the worker thread, keeping the last capacity values of
+    // num_channels channels, with room for queue_frames pending frames
+    // (rounded up to a power of two). Values are filtered by
+    // RingBuffer.Filter, configure it before Start()
+    void Start( int num_channels, int capacity, int queue_frames = 1024 );
+    // Stop and join the worker thread, pending frames are discarded
+    void Stop();
+    bool IsRunning() const { return Worker.joinable(); }
+
+    // Producer thread: Returns false if the queue is full and the frame
+    // was dropped, frame_values[NumChannels]
+    bool Push( const float* frame_values );
+
+    // UI thread: Envelope resolution, usually the plot width in pixels
+    void SetNumColumns( int num_columns ) { NumColumns.store( num_columns > 0 ? num_columns : 1, std::memory_order_relaxed ); }
+    // UI thread: Latest published snapshot, valid until the next call
+    const Snapshot* AcquireSnapshot();
+
+    int                       NumChannels = 0;
+    std::atomic<ImU32>        NumDropped{0};     //Frames dropped by Push() on a full queue
+    int                       IdleSleepUs = 1000; //Worker sleep when there are no new frames, set before Start()
+
+    //-- Internal
+    // Frame queue, producer writes at QueueTail and worker reads at
+    // QueueHead, both wrap around modulo 2^32
+    int                       QueueFrames = 0;
+    ImVector<float>           Queue;             //[QueueFrames][NumChannels]
+    std::atomic<ImU32>        QueueHead{0};
+    std::atomic<ImU32>        QueueTail{0};
+    // Triple buffer, Back is owned by the worker, Front by the UI
+    // thread, and Middle holds the last published one plus cFreshBit
+    // until the UI thread swaps it with Front
+    enum { cFreshBit = 4, cIndexMask = 3 };
+    Snapshot                  Snapshots[3];
+    int                       Back = 2;
+    int                       Front = 0;
+    std::atomic<int>          Middle{1};
+    // Worker
+    MultiPlotLines_RingBuffer RingBuffer;        //Worker thread only, except RingBuffer.Filter settings before Start()
+    std::atomic<int>          NumColumns{cDefaultNumColumns};
+    std::atomic<bool>         bStopRequested{false};
+    std::thread               Worker;
+
+    void WorkerLoop();
+    void BuildSnapshot( Snapshot& snapshot, int num_columns ) const;
+};
+
+// ImGui::MultiPlotLines_ThreadPool
+//
+// Small pool of worker threads implementing
+// MultiPlotLines_Params::parallel_for, so that per-channel work of wide
+// plots is spread across cores:
+// - Tasks are claimed one at a time from a shared counter by the
+//   workers and the calling thread, so uneven tasks balance themselves
+// - ParallelFor() returns once all tasks are done, and must not be
+//   called concurrently or recursively on the same pool
+//
+// Usage:
+//   pool.Start(); //hardware threads - 1 workers
+//   params.parallel_for = ImGui::MultiPlotLines_ThreadPool::ParallelFor;
+//   params.parallel_for_data = &pool;
+struct MultiPlotLines_ThreadPool
+{
+    typedef MultiPlotLines_Params::pt_fn_t pt_fn_t;
+
+    MultiPlotLines_ThreadPool() {}
+    ~MultiPlotLines_ThreadPool() { Stop(); }
+
+    // Start num_workers threads, 0 means one less than hardware threads
+    void Start( int num_workers = 0 );
+    void Stop();
+
+    // MultiPlotLines_Params::parallel_for, data must point to the MultiPlotLines_ThreadPool
+    static void ParallelFor( void* data, int num_tasks, pt_fn_t* task, void* task_data );
+
+    //-- Internal
+    ImVector<std::thread*>    Workers;
+    std::mutex                Mutex;
+    std::condition_variable   WakeUp;
+    bool                      bStopRequested = false; //Mutex
+    // Current job, opened/closed under Mutex
+    bool                      bJobOpen = false;
+    ImU32                     JobGeneration = 0;
+    pt_fn_t*                  JobTask = nullptr;
+    void*                     JobTaskData = nullptr;
+    int                       JobNumTasks = 0;
+    std::atomic<int>          JobNextTask{0};
+    std::atomic<int>          JobDoneTasks{0};
+    std::atomic<int>          JobActiveWorkers{0};
+
+    void WorkerLoop();
+    void RunTasks();
+};
+
+} //namespace ImGui
+
+#endif //IMGUI_MULTIPLOTLINES_ASYNC
@@ -0,0 +1,485 @@
+//----------------------------------------------------------------
+// ImGui::MultiPlotLines_Capture
+//----------------------------------------------------------------
+#include "imgui_multiplotlines_capture.h"
+#include "imgui_multiplotlines_internal.h"
+#ifndef IMGUI_DEFINE_MATH_OPERATORS
+#define IMGUI_DEFINE_MATH_OPERATORS
+#endif
+#include <imgui/imgui_internal.h>
+#include <string.h> //memcpy, memcmp, strlen
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define IMGUI_MULTIPLOTLINES_MMAP
+#endif
+
+namespace ImGui
+{
+
+namespace
+{
+
+typedef MultiPlotLines_CaptureHeader Header;
+const char c_CaptureMagic[8] = { 'M','P','L','C','A','P','0','1' };
+const char c_IndexMagic[8]   = { 'M','P','L','I','D','X','0','1' };
+
+using MultiPlotLinesInternal::AccumulateMinMax;
+
+// Index level sizes, until a single node covers all values
+int ComputeLevelNodes( int num_values, int block_size, int* level_nodes )
+{
+    int num_levels = 0;
+    for( int it_level=0; it_level<MultiPlotLines_Capture::cMaxLevels; it_level++ )
+    {
+        const ImS64 node_size = (ImS64)block_size << it_level;
+        level_nodes[it_level] = (int)( (num_values + node_size - 1) / node_size );
+        num_levels = it_level+1;
+        if( level_nodes[it_level] <= 1 )
+            break;
+    }
+    return num_levels;
+}
+
+#if defined(IMGUI_MULTIPLOTLINES_MMAP)
+// Maps a whole file read-only, returns nullptr on failure
+void* MapFile( const char* path, size_t& size )
+{
+    const int fd = open( path, O_RDONLY );
+    if( fd == -1 )
+        return nullptr;
+    struct stat st;
+    void* mapping = nullptr;
+    if( fstat( fd, &st ) == 0 && st.st_size >= (off_t)sizeof(Header) )
+    {
+        size = (size_t)st.st_size;
+        mapping = mmap( nullptr, size, PROT_READ, MAP_SHARED, fd, 0 );
+        if( mapping == MAP_FAILED )
+            mapping = nullptr;
+    }
+    close( fd ); //mapping keeps the file open
+    return mapping;
+}
+
+// madvise() on whole pages overlapping [ptr,ptr+size)
+void AdvisePages( const void* ptr, size_t size, int advice )
+{
+    static const size_t page_size = (size_t)sysconf( _SC_PAGESIZE );
+    const size_t begin = (size_t)ptr & ~(page_size-1);
+    const size_t end = (size_t)ptr + size;
+    if( end > begin )
+        madvise( (void*)begin, end - begin, advice );
+}
+
+bool WriteAll( int fd, const void* data, size_t size, ImS64 offset )
+{
+    const char* bytes = (const char*)data;
+    while( size > 0 )
+    {
+        const ssize_t written = pwrite( fd, bytes, size, (off_t)offset );
+        if( written <= 0 )
+            return false;
+        bytes += written;
+        size -= (size_t)written;
+        offset += written;
+    }
+    return true;
+}
+#endif
+
+} //namespace
+
+//----------------------------------------------------------------
+// ImGui::MultiPlotLines_Capture
+//----------------------------------------------------------------
+bool MultiPlotLines_Capture::Open( const char* path, const char* index_path )
+{
+    Close();
+#if defined(IMGUI_MULTIPLOTLINES_MMAP)
+    DataMapping = MapFile( path, DataMappingSize );
+    if( !DataMapping )
+        return false;
+    // Header fields are untrusted, sizes are compared by division so they can't wrap
+    const Header* header = (const Header*)DataMapping;
+    const ImU64 data_mapping_size = DataMappingSize;
+    if( memcmp( header->Magic, c_CaptureMagic, sizeof(c_CaptureMagic) ) != 0
+        || header->Version != Header::cVersion
+        || header->NumChannels == 0 || header->NumChannels > 0x7FFFFFFF
+        || header->NumValues < 2 || header->NumValues > 0x7FFFFFFF
+        || header->DataOffset % sizeof(float) != 0 || header->DataOffset > data_mapping_size
+        || header->NumValues > (data_mapping_size - header->DataOffset) / sizeof(float) / header->NumChannels )
+    {
+        Close();
+        return false;
+    }
+    NumChannels = (int)header->NumChannels;
+    NumValues = (int)header->NumValues;
+    Values = (const float*)( (const char*)DataMapping + header->DataOffset );
+    AdvisePages( Values, (size_t)NumChannels * NumValues * sizeof(float), MADV_RANDOM );
+    Channels.resize( NumChannels );
+    for( int it_channel=0; it_channel<NumChannels; it_channel++ )
+    {
+        ChannelState& state = Channels[it_channel];
+        state.ScanEnd = state.ReadAheadEnd = -1;
+        state.SpanBegin = state.SpanEnd = 0;
+    }
+
+    // Index, optional
+    ImVector<char> default_index_path;
+    if( !index_path )
+    {
+        const int path_length = (int)strlen( path );
+        default_index_path.resize( path_length + 5 );
+        memcpy( default_index_path.Data, path, path_length );
+        memcpy( default_index_path.Data + path_length, ".idx", 5 );
+        index_path = default_index_path.Data;
+    }
+    IndexMapping = MapFile( index_path, IndexMappingSize );
+    if( IndexMapping )
+    {
+        const Header* index_header = (const Header*)IndexMapping;
+        const ImU64 index_mapping_size = IndexMappingSize;
+        bool bValid = memcmp( index_header->Magic, c_IndexMagic, sizeof(c_IndexMagic) ) == 0
+                      && index_header->Version == Header::cVersion
+                      && index_header->NumChannels == (ImU32)NumChannels && index_header->NumValues == (ImU64)NumValues
+                      && index_header->IndexBlockSize > 0 && index_header->IndexBlockSize <= 0x40000000
+                      && index_header->NumLevels > 0 && index_header->NumLevels <= (ImU32)cMaxLevels
+                      && index_header->DataOffset % sizeof(float) == 0 && index_header->DataOffset <= index_mapping_size;
+        int level_nodes[cMaxLevels] = {};
+        const int num_levels = bValid ? ComputeLevelNodes( NumValues, (int)index_header->IndexBlockSize, level_nodes ) : 0;
+        bValid = bValid && index_header->NumLevels == (ImU32)num_levels;
+        ImU64 index_remaining = bValid ? index_mapping_size - index_header->DataOffset : 0;
+        for( int it_level=0; bValid && it_level<num_levels; it_level++ )
+        {
+            bValid = (ImU64)level_nodes[it_level] <= index_remaining / sizeof(ImVec2) / (ImU64)NumChannels;
+            if( bValid )
+                index_remaining -= (ImU64)NumChannels * level_nodes[it_level] * sizeof(ImVec2);
+        }
+        if( bValid )
+        {
+            IndexBlockSize = (int)index_header->IndexBlockSize;
+            NumLevels = num_levels;
+            const char* level = (const char*)IndexMapping + index_header->DataOffset;
+            for( int it_level=0; it_level<num_levels; it_level++ )
+            {
+                Levels[it_level] = (const ImVec2*)level;
+                LevelNodes[it_level] = level_nodes[it_level];
+                level += (size_t)NumChannels * level_nodes[it_level] * sizeof(ImVec2);
+            }
+            AdvisePages( IndexMapping, IndexMappingSize, MADV_WILLNEED );
+        }
+        else
+        {
+            munmap( IndexMapping, IndexMappingSize );
+            IndexMapping = nullptr;
+            IndexMappingSize = 0;
+        }
+    }
+    return true;
+#else
+    IM_UNUSED( path );
+    IM_UNUSED( index_path );
+    return false;
+#endif
+}
+
+void MultiPlotLines_Capture::Close()
+{
+#if defined(IMGUI_MULTIPLOTLINES_MMAP)
+    if( DataMapping )
+        munmap( DataMapping, DataMappingSize );
+    if( IndexMapping )
+        munmap( IndexMapping, IndexMappingSize );
+#endif
+    DataMapping = IndexMapping = nullptr;
+    DataMappingSize = IndexMappingSize = 0;
+    NumChannels = NumValues = IndexBlockSize = NumLevels = 0;
+    Values = nullptr;
+    for( int it_level=0; it_level<cMaxLevels; it_level++ )
+    {
+        Levels[it_level] = nullptr;
+        LevelNodes[it_level] = 0;
+    }
+    Channels.clear();
+}
+
+void MultiPlotLines_Capture::Trim()
+{
+    for( int it_channel=0; it_channel<NumChannels; it_channel++ )
+        TrimChannel( it_channel );
+}
+
+void MultiPlotLines_Capture::TrimChannel( int channel_idx )
+{
+    ChannelState& state = Channels[channel_idx];
+#if defined(IMGUI_MULTIPLOTLINES_MMAP)
+    // Pages shared with neighbouring channels are dropped too, they're
+    // clean file pages that are simply read again
+    if( state.SpanEnd > state.SpanBegin )
+        AdvisePages( Values + (ImS64)channel_idx*NumValues + state.SpanBegin, (size_t)(state.SpanEnd - state.SpanBegin) * sizeof(float), MADV_DONTNEED );
+#endif
+    state.SpanBegin = state.SpanEnd = 0;
+    state.ReadAheadEnd = -1;
+}
+
+const float* MultiPlotLines_Capture::TouchValues( int channel_idx, int first_value_idx, int num_values )
+{
+    ChannelState& state = Channels[channel_idx];
+    const float* channel_values = Values + (ImS64)channel_idx*NumValues;
+    ImS64 end_idx = first_value_idx + num_values;
+
+    // Sequential fetches read ahead, once per cReadAheadBytes
+    const ImS64 read_ahead_values = cReadAheadBytes / sizeof(float);
+    if( first_value_idx == state.ScanEnd && end_idx > state.ReadAheadEnd && end_idx < NumValues )
+    {
+        state.ReadAheadEnd = ImMin( end_idx + read_ahead_values, (ImS64)NumValues );
+#if defined(IMGUI_MULTIPLOTLINES_MMAP)
+        AdvisePages( channel_values + end_idx, (size_t)(state.ReadAheadEnd - end_idx) * sizeof(float), MADV_WILLNEED );
+#endif
+    }
+    state.ScanEnd = end_idx;
+    end_idx = ImMax( end_idx, state.ReadAheadEnd );
+
+    // Bound resident pages by the fetched span, trimmed as it outgrows its budget share
+    if( state.SpanEnd <= state.SpanBegin )
+    {
+        state.SpanBegin = first_value_idx;
+        state.SpanEnd = end_idx;
+    }
+    else
+    {
+        const ImS64 span_begin = ImMin( state.SpanBegin, (ImS64)first_value_idx );
+        const ImS64 span_end = ImMax( state.SpanEnd, end_idx );
+        const ImS64 budget_values = (ImS64)( ResidentBudget / sizeof(float) / NumChannels );
+        if( ResidentBudget > 0 && span_end - span_begin > ImMax( budget_values, read_ahead_values ) )
+        {
+            TrimChannel( channel_idx );
+            state.SpanBegin = first_value_idx;
+            state.SpanEnd = first_value_idx + num_values;
+        }
+        else
+        {
+            state.SpanBegin = span_begin;
+            state.SpanEnd = span_end;
+        }
+    }
+    return channel_values + first_value_idx;
+}
+
+void MultiPlotLines_Capture::ReadValues( int first_value_idx, int num_values, int channel_idx, float* values )
+{
+    IM_ASSERT( first_value_idx >= 0 && first_value_idx + num_values <= NumValues );
+    memcpy( values, TouchValues( channel_idx, first_value_idx, num_values ), num_values * sizeof(float) );
+}
+
+bool MultiPlotLines_Capture::GetRange( int channel_idx, int first_value_idx, int num_values, float& v_min, float& v_max )
+{
+    const int end_value_idx = first_value_idx + num_values;
+    if( NumLevels == 0 || first_value_idx < 0 || end_value_idx > NumValues )
+        return false;
+
+    // Whole index blocks [lo,hi), the last one may be partial, and
+    // values at unaligned edges unless the range is long enough to
+    // include edge blocks instead
+    int lo = (first_value_idx + IndexBlockSize - 1) / IndexBlockSize;
+    int hi = end_value_idx == NumValues ? LevelNodes[0] : end_value_idx / IndexBlockSize;
+    if( hi - lo >= cApproxEdgeBlocks )
+    {
+        lo = first_value_idx / IndexBlockSize;
+        hi = (end_value_idx + IndexBlockSize - 1) / IndexBlockSize;
+    }
+    else
+    {
+        const int first_whole_idx = ImMin( lo * IndexBlockSize, end_value_idx );
+        const int end_whole_idx = ImMax( ImMin( hi * IndexBlockSize, end_value_idx ), first_whole_idx );
+        if( first_value_idx < first_whole_idx )
+            AccumulateMinMax( TouchValues( channel_idx, first_value_idx, first_whole_idx - first_value_idx ), first_whole_idx - first_value_idx, v_min, v_max );
+        if( end_whole_idx < end_value_idx )
+            AccumulateMinMax( TouchValues( channel_idx, end_whole_idx, end_value_idx - end_whole_idx ), end_value_idx - end_whole_idx, v_min, v_max );
+    }
+
+    // Combine whole blocks bottom-up, using the largest nodes that fit,
+    // as in a segment tree
+    for( int it_level=0; lo<hi && it_level<NumLevels; it_level++ )
+    {
+        const ImVec2* level = Levels[it_level] + (ImS64)channel_idx * LevelNodes[it_level];
+        if( lo & 1 )
+        {
+            const ImVec2& range = level[lo++];
+            v_min = ImMin( v_min, range.x );
+            v_max = ImMax( v_max, range.y );
+        }
+        if( hi & 1 )
+        {
+            const ImVec2& range = level[--hi];
+            v_min = ImMin( v_min, range.x );
+            v_max = ImMax( v_max, range.y );
+        }
+        lo >>= 1;
+        hi >>= 1;
+    }
+    return true;
+}
+
+void MultiPlotLines_Capture::GetValues( void* data, int first_value_idx, int num_values, int channel_idx, float* values )
+{
+    ((MultiPlotLines_Capture*)data)->ReadValues( first_value_idx, num_values, channel_idx, values );
+}
+
+bool MultiPlotLines_Capture::GetChannelRange( const void* data, int channel_idx, int first_value_idx, int num_values, float* v_min, float* v_max )
+{
+    // Fetches update per-channel access state, capture values are never modified
+    return ((MultiPlotLines_Capture*)data)->GetRange( channel_idx, first_value_idx, num_values, *v_min, *v_max );
+}
+
+//----------------------------------------------------------------
+// ImGui::MultiPlotLines_CaptureWriter
+//----------------------------------------------------------------
+bool MultiPlotLines_CaptureWriter::Open( const char* path, int num_channels, int num_values )
+{
+    IM_ASSERT( num_channels > 0 && num_values >= 2 );
+    Close();
+    // Chunk and Blocks are indexed in int
+    const int num_blocks = (int)( ((ImS64)num_values + Header::cIndexBlockSize - 1) / Header::cIndexBlockSize );
+    if( (ImS64)num_channels * cChunkFrames > 0x7FFFFFFF || (ImS64)num_channels * num_blocks > 0x7FFFFFFF )
+        return false;
+    NumChannels = num_channels;
+    NumValues = num_values;
+    NumPushed = 0;
+    ChunkSize = 0;
+    bFailed = false;
+    Chunk.resize( num_channels * cChunkFrames );
+    Blocks.resize( num_channels * num_blocks );
+    for( int it_block=0; it_block<Blocks.Size; it_block++ )
+        Blocks[it_block] = ImVec2( FLT_MAX, -FLT_MAX );
+    const int path_length = (int)strlen( path );
+    IndexPath.resize( path_length + 5 );
+    memcpy( IndexPath.Data, path, path_length );
+    memcpy( IndexPath.Data + path_length, ".idx", 5 );
+#if defined(IMGUI_MULTIPLOTLINES_MMAP)
+    Fd = open( path, O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+    if( Fd == -1 )
+        return false;
+    Header header = {};
+    memcpy( header.Magic, c_CaptureMagic, sizeof(c_CaptureMagic) );
+    header.Version = Header::cVersion;
+    header.NumChannels = (ImU32)num_channels;
+    header.NumValues = (ImU64)num_values;
+    header.DataOffset = Header::cDataOffset;
+    header.IndexBlockSize = Header::cIndexBlockSize;
+    // Sized upfront, values are then written channel by channel
+    const ImS64 file_size = Header::cDataOffset + (ImS64)num_channels * num_values * sizeof(float);
+    if( !WriteAll( Fd, &header, sizeof(header), 0 ) || ftruncate( Fd, (off_t)file_size ) != 0 )
+    {
+        close( Fd );
+        Fd = -1;
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool MultiPlotLines_CaptureWriter::Push( const float* frames, int num_frames )
+{
+    if( Fd == -1 || NumPushed + ChunkSize + num_frames > NumValues )
+        bFailed = true;
+    if( bFailed )
+        return false;
+    for( int it_frame=0; it_frame<num_frames; it_frame++ )
+    {
+        const float* frame = frames + (ImS64)it_frame * NumChannels;
+        for( int it_channel=0; it_channel<NumChannels; it_channel++ )
+            Chunk[it_channel*cChunkFrames + ChunkSize] = frame[it_channel];
+        if( ++ChunkSize == cChunkFrames )
+            FlushChunk();
+    }
+    return !bFailed;
+}
+
+void MultiPlotLines_CaptureWriter::FlushChunk()
+{
+    if( ChunkSize == 0 )
+        return;
+    // Chunks start at multiples of cChunkFrames, so they cover whole index blocks, but the last one
+    const int num_blocks = Blocks.Size / NumChannels;
+    for( int it_channel=0; it_channel<NumChannels; it_channel++ )
+    {
+        const float* values = &Chunk[it_channel*cChunkFrames];
+        for( int it_value=0; it_value<ChunkSize; it_value+=Header::cIndexBlockSize )
+        {
+            ImVec2& range = Blocks[it_channel*num_blocks + (NumPushed + it_value) / Header::cIndexBlockSize];
+            AccumulateMinMax( values + it_value, ImMin( (int)Header::cIndexBlockSize, ChunkSize - it_value ), range.x, range.y );
+        }
+#if defined(IMGUI_MULTIPLOTLINES_MMAP)
+        const ImS64 offset = Header::cDataOffset + ((ImS64)it_channel * NumValues + NumPushed) * (ImS64)sizeof(float);
+        if( !bFailed && !WriteAll( Fd, values, ChunkSize * sizeof(float), offset ) )
+            bFailed = true;
+#endif
+    }
+    NumPushed += ChunkSize;
+    ChunkSize = 0;
+}
+
+bool MultiPlotLines_CaptureWriter::Close()
+{
+    if( Fd == -1 )
+        return false;
+    FlushChunk();
+    bool bOk = !bFailed && NumPushed == NumValues;
+#if defined(IMGUI_MULTIPLOTLINES_MMAP)
+    bOk = close( Fd ) == 0 && bOk;
+    Fd = -1;
+    if( !bOk )
+        return false;
+
+    // Index levels, each node combines its 2 children
+    int level_nodes[MultiPlotLines_Capture::cMaxLevels] = {};
+    const int num_levels = ComputeLevelNodes( NumValues, Header::cIndexBlockSize, level_nodes );
+    const int fd = open( IndexPath.Data, O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+    if( fd == -1 )
+        return false;
+    Header header = {};
+    memcpy( header.Magic, c_IndexMagic, sizeof(c_IndexMagic) );
+    header.Version = Header::cVersion;
+    header.NumChannels = (ImU32)NumChannels;
+    header.NumValues = (ImU64)NumValues;
+    header.DataOffset = sizeof(Header);
+    header.IndexBlockSize = Header::cIndexBlockSize;
+    header.NumLevels = (ImU32)num_levels;
+    bOk = WriteAll( fd, &header, sizeof(header), 0 );
+    ImS64 offset = sizeof(Header);
+    ImVector<ImVec2> level, parent_level;
+    level.swap( Blocks );
+    for( int it_level=0; bOk && it_level<num_levels; it_level++ )
+    {
+        bOk = WriteAll( fd, level.Data, level.Size * sizeof(ImVec2), offset );
+        offset += level.Size * sizeof(ImVec2);
+        if( it_level+1 == num_levels )
+            break;
+        const int num_children = level_nodes[it_level];
+        const int num_parents = level_nodes[it_level+1];
+        parent_level.resize( NumChannels * num_parents );
+        for( int it_channel=0; it_channel<NumChannels; it_channel++ )
+            for( int it_node=0; it_node<num_parents; it_node++ )
+            {
+                ImVec2 range = level[it_channel*num_children + 2*it_node];
+                if( 2*it_node+1 < num_children )
+                {
+                    const ImVec2& range1 = level[it_channel*num_children + 2*it_node+1];
+                    range.x = ImMin( range.x, range1.x );
+                    range.y = ImMax( range.y, range1.y );
+                }
+                parent_level[it_channel*num_parents + it_node] = range;
+            }
+        level.swap( parent_level );
+    }
+    bOk = close( fd ) == 0 && bOk;
+#endif
+    return bOk;
+}
+
+} //namespace ImGui
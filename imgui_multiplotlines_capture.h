@@ -0,0 +1,161 @@
+//----------------------------------------------------------------
+// ImGui::MultiPlotLines_Capture
+//----------------------------------------------------------------
+#ifndef IMGUI_MULTIPLOTLINES_CAPTURE
+#define IMGUI_MULTIPLOTLINES_CAPTURE
+
+#include "imgui_multiplotlines.h"
+
+namespace ImGui
+{
+
+// ImGui::MultiPlotLines_CaptureHeader
+//
+// Capture file format, little-endian:
+// - 64 bytes header, followed by channel-major float32 values at
+//   DataOffset: value i of channel c is at
+//   DataOffset + (c*NumValues + i)*sizeof(float)
+// - Sidecar index file (capture path + ".idx"): 64 bytes header with
+//   Magic "MPLIDX01", followed by NumLevels min/max levels, level l
+//   being [NumChannels][ceil(NumValues/(IndexBlockSize<<l))] float
+//   pairs (min,max), ignoring NaN, until a single node covers all values
+struct MultiPlotLines_CaptureHeader
+{
+    enum EConstants { cVersion = 1, cDataOffset = 4096, cIndexBlockSize = 1024 };
+
+    char  Magic[8];       //"MPLCAP01" or "MPLIDX01"
+    ImU32 Version;
+    ImU32 NumChannels;
+    ImU64 NumValues;      //Values per channel
+    ImU64 DataOffset;     //Capture: page aligned values offset, Index: levels offset
+    ImU32 IndexBlockSize; //Values per level 0 index node
+    ImU32 NumLevels;      //Index only
+    ImU32 Reserved[6];
+};
+
+// ImGui::MultiPlotLines_Capture
+//
+// Read-only capture file mapped in memory (POSIX mmap), so opening it
+// is O(1) regardless of its size and only pages of values actually
+// fetched are read from disk:
+// - get_channel_range() queries are answered from the sidecar min/max
+//   index as a segment tree, so autoscale and eD_MinMax zoomed-out views
+//   don't touch values, only ranges spanning less than
+//   cApproxEdgeBlocks index blocks scan values at unaligned edges.
+//   Longer ranges may include up to IndexBlockSize-1 neighbouring
+//   values at each edge instead, less than a pixel when zoomed out
+// - Values are mapped with MADV_RANDOM, and sequential fetches of a
+//   channel (ex: drawing it at full resolution) read ahead the next
+//   cReadAheadBytes with MADV_WILLNEED
+// - Resident pages of a channel are dropped (MADV_DONTNEED) once the
+//   span of its fetched values exceeds its share of ResidentBudget (at
+//   least cReadAheadBytes), so resident memory stays bounded when
+//   scrolling through huge captures. Trim() drops all of them
+//
+// Fetches of different channels may run concurrently, ex: with
+// MultiPlotLines_Params::parallel_for. Open() fails on platforms
+// without mmap.
+//
+// Usage:
+//   capture.Open( "run.mplcap" ); //and "run.mplcap.idx"
+//   params.get_channel_range = ImGui::MultiPlotLines_Capture::GetChannelRange;
+//   params.Decimation = ImGui::MultiPlotLines_Params::eD_MinMax;
+//   params.DataGeneration = 1; //values never change
+//   params.bZoomPanUI = true;
+//   ImGui::MultiPlotLines( label, ImGui::MultiPlotLines_Capture::GetValues, &capture, capture.NumValues, capture.NumChannels, &params );
+struct MultiPlotLines_Capture
+{
+    enum EConstants { cMaxLevels = 32, cApproxEdgeBlocks = 64, cReadAheadBytes = 1 << 20 };
+
+    int           NumChannels    = 0;
+    int           NumValues      = 0;         //Values per channel
+    int           IndexBlockSize = 0;
+    int           NumLevels      = 0;         //0 if the index is missing, get_channel_range() then fails and values are scanned
+    size_t        ResidentBudget = 256 << 20; //Bytes of values kept resident before trimming, 0 disables trimming
+    const float*  Values         = nullptr;   //[NumChannels][NumValues] mapped values
+    const ImVec2* Levels[cMaxLevels]     = {}; //[level][NumChannels][LevelNodes[level]] mapped index (x=min,y=max)
+    int           LevelNodes[cMaxLevels] = {};
+
+    MultiPlotLines_Capture() {}
+    ~MultiPlotLines_Capture() { Close(); }
+
+    // Map a capture and its index (index_path defaults to path + ".idx"),
+    // returns false if the capture is missing or invalid. A missing or
+    // mismatching index only disables range queries
+    bool Open( const char* path, const char* index_path = nullptr );
+    void Close();
+    // Drop resident pages of all channels, they're read again on demand
+    void Trim();
+
+    // Values [first_value_idx,first_value_idx+num_values) of a channel
+    void ReadValues( int first_value_idx, int num_values, int channel_idx, float* values );
+    // Accumulates min/max of a range of values, ignoring NaN, returns false if out of bounds or without index
+    bool GetRange( int channel_idx, int first_value_idx, int num_values, float& v_min, float& v_max );
+
+    // MultiPlotLines() get_values and get_channel_range callbacks, data must point to the MultiPlotLines_Capture
+    static void GetValues( void* data, int first_value_idx, int num_values, int channel_idx, float* values );
+    static bool GetChannelRange( const void* data, int channel_idx, int first_value_idx, int num_values, float* v_min, float* v_max );
+
+    //-- Internal
+    // Per-channel access state, only touched by fetches of that channel
+    struct ChannelState
+    {
+        ImS64 ScanEnd;      //End of the last fetch, values
+        ImS64 ReadAheadEnd; //End of values already advised, values
+        ImS64 SpanBegin;    //Fetched span since last trim, values
+        ImS64 SpanEnd;
+    };
+    ImVector<ChannelState> Channels;
+    void*  DataMapping      = nullptr;
+    size_t DataMappingSize  = 0;
+    void*  IndexMapping     = nullptr;
+    size_t IndexMappingSize = 0;
+
+    const float* TouchValues( int channel_idx, int first_value_idx, int num_values );
+    void TrimChannel( int channel_idx );
+};
+
+// ImGui::MultiPlotLines_CaptureWriter
+//
+// Writes a capture file and its sidecar index from interleaved frames
+// (one value per channel), transposed in chunks of cChunkFrames frames
+// so that values are written channel-major without holding them all.
+// The number of values must be known upfront, as channels are laid out
+// back to back.
+//
+// Usage:
+//   writer.Open( "run.mplcap", num_channels, num_values );
+//   writer.Push( frames, num_frames ); //[num_frames][num_channels], until num_values are pushed
+//   writer.Close(); //writes "run.mplcap.idx"
+struct MultiPlotLines_CaptureWriter
+{
+    enum EConstants { cChunkFrames = 4 * MultiPlotLines_CaptureHeader::cIndexBlockSize };
+
+    int   NumChannels = 0;
+    int   NumValues   = 0; //Values per channel declared by Open()
+    int   NumPushed   = 0;
+
+    MultiPlotLines_CaptureWriter() {}
+    ~MultiPlotLines_CaptureWriter() { Close(); }
+
+    // Returns false on errors or if num_channels*cChunkFrames exceeds 2^31-1
+    bool Open( const char* path, int num_channels, int num_values );
+    // Appends interleaved frames[num_frames][NumChannels], returns false on write errors or if more than NumValues are pushed
+    bool Push( const float* frames, int num_frames );
+    // Flushes values and writes the index, returns false on errors or if less than NumValues were pushed
+    bool Close();
+
+    //-- Internal
+    int              Fd = -1;
+    bool             bFailed = false;
+    int              ChunkSize = 0; //Frames in Chunk
+    ImVector<float>  Chunk;         //[NumChannels][cChunkFrames]
+    ImVector<ImVec2> Blocks;        //[NumChannels][NumBlocks] level 0 index (x=min,y=max)
+    ImVector<char>   IndexPath;
+
+    void FlushChunk();
+};
+
+} //namespace ImGui
+
+#endif //IMGUI_MULTIPLOTLINES_CAPTURE
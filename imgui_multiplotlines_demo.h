@@ -27,10 +27,40 @@ inline void MultiPlotLines_Demo()
     // MultiPlotLines function parameters
     static int num_channels(2), num_values(100);
     static bool bUseDefaultParams(false);
+    static bool bStreaming(false);
+    static bool bHierarchy(false);
+    static int streaming_filter(ImGui::MultiPlotLines_Filter::eF_None);
     if( ImGui::CollapsingHeader("MPL function params") )
     {
-        ImGui::SliderInt("NumChannels",&num_channels,1,ImGui::MultiPlotLines_Params::cMaxChannels);
-        ImGui::SliderInt("NumValues",&num_values,2,1000);
+        ImGui::SliderInt("NumChannels",&num_channels,1,1024,"%d",ImGuiSliderFlags_Logarithmic);
+        ImGui::SliderInt("NumValues",&num_values,2,100000,"%d",ImGuiSliderFlags_Logarithmic);
+        ImGui::Checkbox("Streaming",&bStreaming);
+        const char* filter_names[] = { "None", "EMA", "MovingAverage", "Median" };
+        ImGui::Combo("StreamingFilter", &streaming_filter, filter_names, IM_ARRAYSIZE(filter_names) );
+        ImGui::Checkbox("Hierarchy",&bHierarchy);
+    }
+
+    // Streaming data source, pushes a few noisy frames per call, filtered incrementally
+    static ImGui::MultiPlotLines_RingBuffer ring_buffer;
+    if( bStreaming )
+    {
+        if( ring_buffer.NumChannels != num_channels || ring_buffer.Capacity != num_values || ring_buffer.Filter.Type != streaming_filter )
+        {
+            ring_buffer.Filter.Type = streaming_filter;
+            ring_buffer.Filter.Alpha = 0.1f;
+            ring_buffer.Filter.Window = 9;
+            ring_buffer.Init( num_channels, num_values );
+        }
+        static int s_FrameIdx(0);
+        static ImVector<float> frame_values;
+        frame_values.resize( num_channels );
+        for( int it_frame=0; it_frame<16; it_frame++, s_FrameIdx++ )
+        {
+            for( int it_channel=0; it_channel<num_channels; it_channel++ )
+                frame_values[it_channel] = sinf( 0.5f * 3.159265f * float(it_channel+1) * float(s_FrameIdx)/100.0f )
+                                           + 0.1f * sinf( 12.9898f * float(s_FrameIdx) + 78.233f * float(it_channel) ); //noise
+            ring_buffer.Push( frame_values.Data );
+        }
     }
 
     // MultiPlotLines_Params struct
@@ -43,27 +73,110 @@ inline void MultiPlotLines_Demo()
             ImGui::Checkbox("bLegendUI", &params.bLegendUI );
             ImGui::Checkbox("HoveredDrawTooltip", &params.HoveredDrawTooltip );
             ImGui::Checkbox("HoveredDrawValue", &params.HoveredDrawValue );
+            const char* legend_mode_names[] = { "Columns", "Tree" };
+            ImGui::Combo("LegendMode", &params.LegendMode, legend_mode_names, IM_ARRAYSIZE(legend_mode_names) );
             ImGui::SliderInt("LegendMaxColumns",&params.LegendMaxColumns,1,10);
+            ImGui::SliderFloat("LegendMaxHeight", &params.LegendMaxHeight, 0.0f, 500.0f );
             ImGui::SliderFloat("PlotDrawThickness", &params.PlotDrawThickness, 1.0f, 3.0f );
             ImGui::SliderFloat("HoveredDrawThickness", &params.HoveredDrawThickness, 0.0f, 2.0f );
             ImGui::SliderFloat("SelectedDrawThickness", &params.SelectedDrawThickness, 0.0f, 2.0f );
+            const char* layout_names[] = { "Overlay", "Lanes" };
+            ImGui::Combo("Layout", &params.Layout, layout_names, IM_ARRAYSIZE(layout_names) );
+            ImGui::SliderFloat("LaneSpacing", &params.LaneSpacing, 0.0f, 8.0f );
+            const char* decimation_names[] = { "None", "MinMax", "LTTB" };
+            ImGui::Combo("Decimation", &params.Decimation, decimation_names, IM_ARRAYSIZE(decimation_names) );
+            ImGui::Checkbox("bRetainGeometry", &params.bRetainGeometry );
         }
     }
 
+    // Instrumentation, per-call Stats summed over all plots in a frame and averaged over the last frames
+    static bool bStats(false);
+    static ImGui::MultiPlotLines_Stats call_stats, frame_stats, rolling_stats;
+    static ImGui::MultiPlotLines_Stats history_stats[60];
+    static int history_pos(0), history_count(0);
+    if( bStats )
+    {
+        rolling_stats.Add( history_stats[history_pos], -1 );
+        history_stats[history_pos] = frame_stats;
+        rolling_stats.Add( frame_stats );
+        history_pos = (history_pos + 1) % IM_ARRAYSIZE(history_stats);
+        if( history_count < IM_ARRAYSIZE(history_stats) )
+            history_count++;
+    }
+    frame_stats.Clear();
+    params.Stats = bStats ? &call_stats : nullptr;
+
+    // Channel hierarchy, each channel has 4 children
+    if( bHierarchy )
+        params.get_channel_parent = []( const void* data, int channel_idx ) { return channel_idx > 0 ? (channel_idx-1)/4 : -1; };
+    else
+        params.get_channel_parent = nullptr;
+
     // Adapt to window size
     const float width( ImGui::GetWindowWidth() - 2*ImGui::GetCursorPosX() );
     const float height( width / (4.0f/3.0f) ); // 4/3 aspect ratio
-    ImGui::MultiPlotLines( "MPL Demo", //must have a non-null name
-                           []( void* data, int slice_idx, int channel_idx )
-                               {
-                                   return sinf( 0.5f * 3.159265f * float(channel_idx+1) * float(slice_idx)/100.0f );
-                               },
-                           nullptr, //data
-                           num_values, //values
-                           num_channels, //channels
-                           bUseDefaultParams ? nullptr : &params, //params (nullptr for default)
-                           FLT_MAX, FLT_MAX, //ranges
-                           ImVec2( width, height ) ); //sizes
+    if( bStreaming )
+    {
+        params.get_channel_range = ImGui::MultiPlotLines_RingBuffer::GetChannelRange;
+        params.DataGeneration = ring_buffer.Generation;
+        ImGui::MultiPlotLines( "MPL Demo", //must have a non-null name
+                               ImGui::MultiPlotLines_RingBuffer::GetValues,
+                               &ring_buffer, //data
+                               ring_buffer.Size, //values
+                               ring_buffer.NumChannels, //channels
+                               bUseDefaultParams ? nullptr : &params, //params (nullptr for default)
+                               FLT_MAX, FLT_MAX, //ranges
+                               ImVec2( width, height ) ); //sizes
+    }
+    else
+    {
+        params.get_channel_range = nullptr;
+        params.DataGeneration = 1; //values never change
+        ImGui::MultiPlotLines( "MPL Demo", //must have a non-null name
+                               []( void* data, int slice_idx, int channel_idx )
+                                   {
+                                       return sinf( 0.5f * 3.159265f * float(channel_idx+1) * float(slice_idx)/100.0f );
+                                   },
+                               nullptr, //data
+                               num_values, //values
+                               num_channels, //channels
+                               bUseDefaultParams ? nullptr : &params, //params (nullptr for default)
+                               FLT_MAX, FLT_MAX, //ranges
+                               ImVec2( width, height ) ); //sizes
+    }
+    if( bStats && !bUseDefaultParams ) //default params have no Stats, call_stats would be stale
+        frame_stats.Add( call_stats );
+
+    // Per-frame averages
+    if( ImGui::CollapsingHeader("MPL stats") )
+    {
+        if( ImGui::Checkbox("Stats", &bStats) )
+        {
+            rolling_stats.Clear();
+            for( int it_frame=0; it_frame<IM_ARRAYSIZE(history_stats); it_frame++ )
+                history_stats[it_frame].Clear();
+            history_pos = history_count = 0;
+        }
+        if( bStats && history_count > 0 )
+        {
+            const double inv_frames = 1.0 / history_count;
+            const char* phase_names[] = { "Autoscale", "Prepare", "Hover", "Draw", "Legend" };
+            ImGui::Text("Frames = %d, Calls/frame = %.1f", history_count, rolling_stats.NumCalls * inv_frames );
+            for( int it_phase=0; it_phase<ImGui::MultiPlotLines_Stats::eP_Count; it_phase++ )
+                ImGui::Text("%-10s %8.3f ms", phase_names[it_phase], rolling_stats.PhaseNs[it_phase] * inv_frames * 1e-6 );
+            ImGui::Text("%-10s %8.3f ms", "Total", rolling_stats.TotalNs * inv_frames * 1e-6 );
+            ImGui::Text("GetValues = %.0f calls, %.0f values, GetRange = %.0f calls",
+                        rolling_stats.NumGetValuesCalls * inv_frames, rolling_stats.NumValuesFetched * inv_frames, rolling_stats.NumGetRangeCalls * inv_frames );
+            ImGui::Text("Channels = %.0f visible, %.0f decimated",
+                        rolling_stats.NumVisibleChannels * inv_frames, rolling_stats.NumDecimatedChannels * inv_frames );
+            ImGui::Text("Segments = %.0f, Vertices = %.0f, Indices = %.0f",
+                        rolling_stats.NumSegments * inv_frames, rolling_stats.NumVertices * inv_frames, rolling_stats.NumIndices * inv_frames );
+            const auto hit_rate_fn = []( ImS64 hits, ImS64 misses ) { return hits + misses > 0 ? 100.0 * double(hits) / double(hits + misses) : 0.0; };
+            ImGui::Text("Range cache hits = %.1f%%, Geometry hits = %.1f%%",
+                        hit_rate_fn( rolling_stats.NumRangeCacheHits, rolling_stats.NumRangeCacheMisses ),
+                        hit_rate_fn( rolling_stats.NumGeometryHits, rolling_stats.NumGeometryMisses ) );
+        }
+    }
 
     // Query RW_ params, only valid if params != nullptr
     if( ImGui::CollapsingHeader("MPL query RW_ params") )
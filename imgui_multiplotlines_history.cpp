@@ -0,0 +1,388 @@
+//----------------------------------------------------------------
+// ImGui::MultiPlotLines_History
+//----------------------------------------------------------------
+#include "imgui_multiplotlines_history.h"
+#include "imgui_multiplotlines_internal.h"
+#ifndef IMGUI_DEFINE_MATH_OPERATORS
+#define IMGUI_DEFINE_MATH_OPERATORS
+#endif
+#include <imgui/imgui_internal.h>
+#include <string.h> //memcpy
+
+namespace ImGui
+{
+
+namespace
+{
+
+typedef MultiPlotLines_History::Block Block;
+enum { cBlockSize = MultiPlotLines_History::cBlockSize };
+
+using MultiPlotLinesInternal::AccumulateMinMax;
+using MultiPlotLinesInternal::CountLeadingZeros;
+using MultiPlotLinesInternal::CountTrailingZeros;
+
+inline ImU32 FloatBits( float f ) { ImU32 bits; memcpy( &bits, &f, sizeof(bits) ); return bits; }
+inline float BitsFloat( ImU32 bits ) { float f; memcpy( &f, &bits, sizeof(f) ); return f; }
+
+// Appends up to 32 bits at a time, MSB first
+struct BitWriter
+{
+    ImVector<ImU64>& Words;
+    int              NumFreeBits; //In Words.back()
+
+    explicit BitWriter( ImVector<ImU64>& words ) : Words(words), NumFreeBits(0) {}
+    void Write( ImU32 bits, int num_bits )
+    {
+        if( NumFreeBits == 0 )
+        {
+            Words.push_back( 0 );
+            NumFreeBits = 64;
+        }
+        if( num_bits <= NumFreeBits )
+        {
+            NumFreeBits -= num_bits;
+            Words.back() |= (ImU64)bits << NumFreeBits;
+        }
+        else
+        {
+            const int num_spilled = num_bits - NumFreeBits;
+            Words.back() |= (ImU64)bits >> num_spilled;
+            NumFreeBits = 64 - num_spilled;
+            Words.push_back( (ImU64)bits << NumFreeBits );
+        }
+    }
+};
+
+// Reads up to 32 bits at a time, MSB first
+struct BitReader
+{
+    const ImU64* Words;
+    ImU64        BitPos;
+
+    ImU32 Read( int num_bits )
+    {
+        const ImU64* word = Words + (BitPos >> 6);
+        const int bit_idx = (int)(BitPos & 63);
+        ImU64 bits = word[0] << bit_idx;
+        if( bit_idx + num_bits > 64 )
+            bits |= word[1] >> (64 - bit_idx);
+        BitPos += num_bits;
+        return (ImU32)(bits >> (64 - num_bits));
+    }
+};
+
+// Gorilla XOR encoding of cBlockSize values: the first value is stored
+// as is, then each value XOR the previous one is stored as:
+// - '0' if equal
+// - '10' + meaningful bits, if they fit in the previous leading/trailing zeros window
+// - '11' + 5 bits leading zeros + 5 bits (length-1) + meaningful bits otherwise
+void EncodeBlock( const float* values, BitWriter& writer )
+{
+    ImU32 prev = FloatBits( values[0] );
+    writer.Write( prev, 32 );
+    int window_lz = 32, window_tz = 32; //No window yet
+    for( int i=1; i<cBlockSize; i++ )
+    {
+        const ImU32 bits = FloatBits( values[i] );
+        const ImU32 x = bits ^ prev;
+        prev = bits;
+        if( x == 0 )
+        {
+            writer.Write( 0, 1 );
+            continue;
+        }
+        const int lz = CountLeadingZeros( x );
+        const int tz = CountTrailingZeros( x );
+        if( lz >= window_lz && tz >= window_tz )
+        {
+            writer.Write( 2, 2 );
+            writer.Write( x >> window_tz, 32 - window_lz - window_tz );
+        }
+        else
+        {
+            const int length = 32 - lz - tz;
+            writer.Write( 3, 2 );
+            writer.Write( (ImU32)(lz << 5 | (length-1)), 10 );
+            writer.Write( x >> tz, length );
+            window_lz = lz;
+            window_tz = tz;
+        }
+    }
+}
+
+void DecodeBlock( const ImU64* words, float* values )
+{
+    BitReader reader = { words, 0 };
+    ImU32 prev = reader.Read( 32 );
+    values[0] = BitsFloat( prev );
+    int shift = 0, length = 32;
+    for( int i=1; i<cBlockSize; i++ )
+    {
+        if( reader.Read( 1 ) )
+        {
+            if( reader.Read( 1 ) )
+            {
+                const ImU32 window = reader.Read( 10 );
+                length = (int)(window & 31) + 1;
+                shift = 32 - (int)(window >> 5) - length;
+            }
+            prev ^= reader.Read( length ) << shift;
+        }
+        values[i] = BitsFloat( prev );
+    }
+}
+
+} //namespace
+
+//----------------------------------------------------------------
+// ImGui::MultiPlotLines_History
+//----------------------------------------------------------------
+void MultiPlotLines_History::Init( int num_channels )
+{
+    IM_ASSERT( num_channels > 0 && MantissaBits >= 0 && MantissaBits <= 23 && CacheBlocks > 0 );
+    NumChannels = num_channels;
+    Tail.resize( num_channels * cBlockSize );
+    CacheKeys.resize( CacheBlocks );
+    CacheLastUse.resize( CacheBlocks );
+    CacheValues.resize( CacheBlocks * cBlockSize );
+    Clear();
+}
+
+void MultiPlotLines_History::Clear()
+{
+    NumValues = 0;
+    NumBlocks = 0;
+    TailSize = 0;
+    Words.clear();
+    Blocks.clear();
+    for( int it_level=0; it_level<cMaxLevels; it_level++ )
+        Levels[it_level].clear();
+    for( int it_slot=0; it_slot<CacheKeys.Size; it_slot++ )
+    {
+        CacheKeys[it_slot] = -1;
+        CacheLastUse[it_slot] = 0; //Empty slots are evicted first
+    }
+    CacheClock = 0;
+    CacheLastHit = 0;
+    NumDecodedBlocks = 0;
+    NumCacheHits = 0;
+    if( ++Generation == 0 ) //0 would disable caching
+        Generation = 1;
+}
+
+void MultiPlotLines_History::Push( const float* frame_values )
+{
+    IM_ASSERT( NumChannels > 0 && NumValues < 0x7FFFFFFF );
+    if( MantissaBits < 23 )
+    {
+        // Round to nearest kept mantissa, values that would round to Inf
+        // are truncated instead, and Inf/NaN are kept as is
+        const ImU32 half = (1u << (23 - MantissaBits)) >> 1;
+        const ImU32 mask = ~((1u << (23 - MantissaBits)) - 1);
+        for( int it_channel=0; it_channel<NumChannels; it_channel++ )
+        {
+            const ImU32 bits = FloatBits( frame_values[it_channel] );
+            ImU32 rounded = (bits + half) & mask;
+            if( (bits & 0x7F800000) == 0x7F800000 )
+                rounded = bits;
+            else if( (rounded & 0x7F800000) == 0x7F800000 )
+                rounded = bits & mask;
+            Tail[it_channel*cBlockSize + TailSize] = BitsFloat( rounded );
+        }
+    }
+    else
+    {
+        for( int it_channel=0; it_channel<NumChannels; it_channel++ )
+            Tail[it_channel*cBlockSize + TailSize] = frame_values[it_channel];
+    }
+    TailSize++;
+    NumValues++;
+    if( TailSize == cBlockSize )
+        SealTail();
+    if( ++Generation == 0 ) //0 would disable caching
+        Generation = 1;
+}
+
+void MultiPlotLines_History::SealTail()
+{
+    // Encode a block per channel
+    const int block_idx = NumBlocks;
+    Blocks.resize( (block_idx+1) * NumChannels );
+    BitWriter writer( Words );
+    for( int it_channel=0; it_channel<NumChannels; it_channel++ )
+    {
+        const float* values = &Tail[it_channel*cBlockSize];
+        Block& block = Blocks[block_idx*NumChannels + it_channel];
+        IM_ASSERT( Words.Size < 0x7FFFFFFF ); //ImVector size limit
+        block.FirstWord = (ImU32)Words.Size;
+        block.Min = FLT_MAX;
+        block.Max = -FLT_MAX;
+        AccumulateMinMax( values, cBlockSize, block.Min, block.Max );
+        writer.NumFreeBits = 0; //Blocks start on a new word
+        EncodeBlock( values, writer );
+    }
+    NumBlocks++;
+    TailSize = 0;
+
+    // Recompute ancestors of the new block from their children, levels
+    // are created as soon as a single node no longer covers all blocks,
+    // and their first node from complete children
+    for( int it_level=0; it_level<cMaxLevels && ((ImS64)1 << it_level) < NumBlocks; it_level++ )
+    {
+        const int node_idx = block_idx >> (it_level+1);
+        const int num_children = it_level == 0 ? NumBlocks : Levels[it_level-1].Size / NumChannels;
+        ImVector<ImVec2>& level = Levels[it_level];
+        level.resize( (node_idx+1) * NumChannels );
+        for( int it_channel=0; it_channel<NumChannels; it_channel++ )
+        {
+            ImVec2 range( FLT_MAX, -FLT_MAX );
+            for( int it_child=2*node_idx; it_child<ImMin(2*node_idx+2,num_children); it_child++ )
+            {
+                const ImVec2 child = it_level == 0 ? ImVec2( Blocks[it_child*NumChannels + it_channel].Min, Blocks[it_child*NumChannels + it_channel].Max )
+                                                   : Levels[it_level-1][it_child*NumChannels + it_channel];
+                range.x = ImMin( range.x, child.x );
+                range.y = ImMax( range.y, child.y );
+            }
+            level[node_idx*NumChannels + it_channel] = range;
+        }
+    }
+}
+
+const float* MultiPlotLines_History::DecodeCached( int block_idx, int channel_idx ) const
+{
+    const ImS64 key = (ImS64)block_idx * NumChannels + channel_idx;
+    CacheClock++;
+    // Consecutive queries usually hit the same block, otherwise find
+    // it or evict the least recently used one
+    int slot = CacheLastHit;
+    if( CacheKeys[slot] != key )
+    {
+        int lru_slot = 0;
+        slot = -1;
+        for( int it_slot=0; it_slot<CacheKeys.Size && slot == -1; it_slot++ )
+        {
+            if( CacheKeys[it_slot] == key )
+                slot = it_slot;
+            else if( CacheLastUse[it_slot] < CacheLastUse[lru_slot] )
+                lru_slot = it_slot;
+        }
+        if( slot == -1 )
+            slot = lru_slot;
+    }
+    float* values = &CacheValues[slot*cBlockSize];
+    if( CacheKeys[slot] == key )
+        NumCacheHits++;
+    else
+    {
+        DecodeBlock( &Words[Blocks[block_idx*NumChannels + channel_idx].FirstWord], values );
+        NumDecodedBlocks++;
+        CacheKeys[slot] = key;
+    }
+    CacheLastUse[slot] = CacheClock;
+    CacheLastHit = slot;
+    return values;
+}
+
+void MultiPlotLines_History::ReadValues( int first_value_idx, int num_values, int channel_idx, float* values ) const
+{
+    IM_ASSERT( first_value_idx >= 0 && first_value_idx + num_values <= NumValues );
+    for( int value_idx=first_value_idx, end_idx=first_value_idx+num_values; value_idx<end_idx; )
+    {
+        const int block_idx = value_idx / cBlockSize;
+        const int offset = value_idx - block_idx*cBlockSize;
+        const int count = ImMin( (int)cBlockSize - offset, end_idx - value_idx );
+        if( block_idx == NumBlocks )
+            memcpy( values, &Tail[channel_idx*cBlockSize + offset], count*sizeof(float) );
+        else if( count == cBlockSize ) //Whole block, sequential scans would only evict cached ones
+        {
+            DecodeBlock( &Words[Blocks[block_idx*NumChannels + channel_idx].FirstWord], values );
+            NumDecodedBlocks++;
+        }
+        else
+            memcpy( values, DecodeCached( block_idx, channel_idx ) + offset, count*sizeof(float) );
+        values += count;
+        value_idx += count;
+    }
+}
+
+bool MultiPlotLines_History::GetRange( int channel_idx, int first_value_idx, int num_values, float& v_min, float& v_max ) const
+{
+    const int end_value_idx = first_value_idx + num_values;
+    if( first_value_idx < 0 || end_value_idx > NumValues )
+        return false;
+
+    // Tail values
+    const int sealed_end_idx = NumBlocks * cBlockSize;
+    if( end_value_idx > sealed_end_idx )
+    {
+        const int tail_first_idx = ImMax( first_value_idx, sealed_end_idx );
+        AccumulateMinMax( &Tail[channel_idx*cBlockSize + tail_first_idx - sealed_end_idx], end_value_idx - tail_first_idx, v_min, v_max );
+    }
+    const int end_idx = ImMin( end_value_idx, sealed_end_idx );
+    if( first_value_idx >= end_idx )
+        return true;
+
+    // Whole blocks [lo,hi) combined bottom-up from headers and levels,
+    // using the largest nodes that fit, as in a segment tree
+    int lo = (first_value_idx + cBlockSize - 1) / cBlockSize;
+    int hi = end_idx / cBlockSize;
+    const int first_whole_idx = lo * cBlockSize;
+    const int end_whole_idx = hi * cBlockSize;
+    for( int it_level=-1; lo<hi; it_level++ )
+    {
+        auto accumulate_node_fn = [this,it_level,channel_idx,&v_min,&v_max]( int node_idx )
+            {
+                const ImVec2 range = it_level < 0 ? ImVec2( Blocks[node_idx*NumChannels + channel_idx].Min, Blocks[node_idx*NumChannels + channel_idx].Max )
+                                                  : Levels[it_level][node_idx*NumChannels + channel_idx];
+                v_min = ImMin( v_min, range.x );
+                v_max = ImMax( v_max, range.y );
+            };
+        if( lo & 1 )
+            accumulate_node_fn( lo++ );
+        if( hi & 1 )
+            accumulate_node_fn( --hi );
+        lo >>= 1;
+        hi >>= 1;
+    }
+
+    // Partial edge blocks, only decoded if their header extends the range
+    auto accumulate_partial_fn = [this,channel_idx,&v_min,&v_max]( int begin, int end )
+        {
+            const int block_idx = begin / cBlockSize;
+            const Block& block = Blocks[block_idx*NumChannels + channel_idx];
+            if( block.Min > block.Max || (block.Min >= v_min && block.Max <= v_max) )
+                return;
+            AccumulateMinMax( DecodeCached( block_idx, channel_idx ) + (begin - block_idx*cBlockSize), end - begin, v_min, v_max );
+        };
+    if( first_whole_idx > end_whole_idx ) //Inside a single block
+        accumulate_partial_fn( first_value_idx, end_idx );
+    else
+    {
+        if( first_value_idx < first_whole_idx )
+            accumulate_partial_fn( first_value_idx, first_whole_idx );
+        if( end_whole_idx < end_idx )
+            accumulate_partial_fn( end_whole_idx, end_idx );
+    }
+    return true;
+}
+
+size_t MultiPlotLines_History::GetCompressedBytes() const
+{
+    size_t num_bytes = Words.Size * sizeof(ImU64) + Blocks.Size * sizeof(Block) + Tail.Size * sizeof(float);
+    for( int it_level=0; it_level<cMaxLevels; it_level++ )
+        num_bytes += Levels[it_level].Size * sizeof(ImVec2);
+    return num_bytes;
+}
+
+void MultiPlotLines_History::GetValues( void* data, int first_value_idx, int num_values, int channel_idx, float* values )
+{
+    ((const MultiPlotLines_History*)data)->ReadValues( first_value_idx, num_values, channel_idx, values );
+}
+
+bool MultiPlotLines_History::GetChannelRange( const void* data, int channel_idx, int first_value_idx, int num_values, float* v_min, float* v_max )
+{
+    return ((const MultiPlotLines_History*)data)->GetRange( channel_idx, first_value_idx, num_values, *v_min, *v_max );
+}
+
+} //namespace ImGui
@@ -0,0 +1,101 @@
+//----------------------------------------------------------------
+// ImGui::MultiPlotLines_History
+//----------------------------------------------------------------
+#ifndef IMGUI_MULTIPLOTLINES_HISTORY
+#define IMGUI_MULTIPLOTLINES_HISTORY
+
+#include "imgui_multiplotlines.h"
+
+namespace ImGui
+{
+
+// ImGui::MultiPlotLines_History
+//
+// Compressed append-only multi-channel history, for keeping long
+// recordings of many channels in memory:
+// - Push() appends a frame with one value per channel into an
+//   uncompressed tail block, sealed once it holds cBlockSize values
+// - Sealed blocks are XOR encoded as in Gorilla ("Gorilla: A Fast,
+//   Scalable, In-Memory Time Series Database", T.Pelkonen et al. 2015),
+//   lossless by default, and keep their min/max in the block header
+// - A segment tree over block headers answers get_channel_range() in
+//   O(log(blocks)), so autoscale and eD_MinMax zoomed-out views never
+//   decode values, and partial edge blocks are only decoded if their
+//   header could extend the range
+// - Values fetched at full resolution are decoded through a small LRU
+//   cache of CacheBlocks blocks, whole blocks bypass it
+//
+// MantissaBits < 23 rounds values to fewer float mantissa bits on
+// Push(), so that XOR differences have more trailing zeros: ex: 12
+// bits keeps a relative precision of 2^-13 and saves about a third of
+// the lossless size of smooth or noisy signals.
+//
+// The decode cache is updated by const queries, so GetValues() and
+// GetChannelRange() are not thread-safe, don't use them together with
+// MultiPlotLines_Params::parallel_for.
+//
+// Usage:
+//   history.Init( num_channels );
+//   history.Push( frame_values ); //for each new frame
+//   params.get_channel_range = ImGui::MultiPlotLines_History::GetChannelRange;
+//   params.Decimation = ImGui::MultiPlotLines_Params::eD_MinMax;
+//   params.DataGeneration = history.Generation;
+//   ImGui::MultiPlotLines( label, ImGui::MultiPlotLines_History::GetValues, &history, history.NumValues, history.NumChannels, &params );
+struct MultiPlotLines_History
+{
+    enum EConstants { cBlockSize = 256, cMaxLevels = 32 };
+
+    // Sealed block of cBlockSize values of a channel
+    struct Block
+    {
+        ImU32 FirstWord; //Encoded bits start at Words[FirstWord]
+        float Min, Max;  //Ignoring NaN, FLT_MAX/-FLT_MAX if all values are NaN
+    };
+
+    int   NumChannels  = 0;
+    int   NumValues    = 0;  //Values per channel, sealed and tail
+    int   NumBlocks    = 0;  //Sealed blocks per channel
+    int   MantissaBits = 23; //Kept float mantissa bits in [0,23], fewer is lossy but compresses better, set before Init()
+    int   CacheBlocks  = 64; //Decoded blocks kept by the LRU cache, set before Init()
+    ImU32 Generation   = 0;  //Incremented on Push()/Clear(), use as MultiPlotLines_Params::DataGeneration
+
+    ImVector<ImU64>  Words;               //Encoded blocks, MSB first
+    ImVector<Block>  Blocks;              //[NumBlocks][NumChannels]
+    ImVector<ImVec2> Levels[cMaxLevels];  //[level][node][NumChannels] (x=min,y=max) of 2^(level+1) blocks
+    ImVector<float>  Tail;                //[NumChannels][cBlockSize] values not sealed yet
+    int              TailSize = 0;
+
+    //-- Internal, LRU decode cache, mutable so that const queries can decode
+    mutable ImVector<ImS64> CacheKeys;    //[CacheBlocks] block_idx*NumChannels+channel_idx, -1 if empty
+    mutable ImVector<ImU32> CacheLastUse; //[CacheBlocks]
+    mutable ImVector<float> CacheValues;  //[CacheBlocks][cBlockSize]
+    mutable ImU32           CacheClock = 0;
+    mutable int             CacheLastHit = 0;
+    mutable ImS64           NumDecodedBlocks = 0; //Blocks decoded, including cache misses
+    mutable ImS64           NumCacheHits = 0;
+
+    void Init( int num_channels );
+    void Clear();
+    void Push( const float* frame_values ); //frame_values[NumChannels]
+
+    // Values [first_value_idx,first_value_idx+num_values) of a channel
+    void ReadValues( int first_value_idx, int num_values, int channel_idx, float* values ) const;
+    // Accumulates min/max of a range of values, ignoring NaN, returns false if out of bounds
+    bool GetRange( int channel_idx, int first_value_idx, int num_values, float& v_min, float& v_max ) const;
+
+    // Memory footprint, compressed (encoded words, headers and tail) and as raw floats
+    size_t GetCompressedBytes() const;
+    size_t GetRawBytes() const { return (size_t)NumValues * NumChannels * sizeof(float); }
+
+    // MultiPlotLines() get_values and get_channel_range callbacks, data must point to the MultiPlotLines_History
+    static void GetValues( void* data, int first_value_idx, int num_values, int channel_idx, float* values );
+    static bool GetChannelRange( const void* data, int channel_idx, int first_value_idx, int num_values, float* v_min, float* v_max );
+
+    //-- Internal
+    void SealTail();
+    const float* DecodeCached( int block_idx, int channel_idx ) const;
+};
+
+} //namespace ImGui
+
+#endif //IMGUI_MULTIPLOTLINES_HISTORY
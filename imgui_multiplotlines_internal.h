@@ -0,0 +1,59 @@
+//----------------------------------------------------------------
+// ImGui::MultiPlotLines internals
+//----------------------------------------------------------------
+// Helpers shared by the MultiPlotLines translation units, not part
+// of the API and subject to change.
+#ifndef IMGUI_MULTIPLOTLINES_INTERNAL
+#define IMGUI_MULTIPLOTLINES_INTERNAL
+
+#include "imgui_multiplotlines.h"
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h> //_BitScanForward, _BitScanReverse
+#endif
+
+namespace ImGui
+{
+namespace MultiPlotLinesInternal
+{
+
+// Accumulate min/max of values into v_min/v_max, ignoring NaN values,
+// SIMD unless IMGUI_MULTIPLOTLINES_DISABLE_SIMD is defined when
+// compiling imgui_multiplotlines.cpp
+void AccumulateMinMax( const float* values, int num_values, float& v_min, float& v_max );
+
+// Index of the lowest set bit, word must be non-zero
+inline int CountTrailingZeros( ImU32 word )
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long bit_idx;
+    _BitScanForward( &bit_idx, word );
+    return (int)bit_idx;
+#elif defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz( word );
+#else
+    int bit_idx = 0;
+    while( (word & 1u) == 0 ) { word >>= 1; bit_idx++; }
+    return bit_idx;
+#endif
+}
+
+// Number of zero bits above the highest set bit, word must be non-zero
+inline int CountLeadingZeros( ImU32 word )
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long bit_idx;
+    _BitScanReverse( &bit_idx, word );
+    return 31 - (int)bit_idx;
+#elif defined(__GNUC__) || defined(__clang__)
+    return __builtin_clz( word );
+#else
+    int num_zeros = 0;
+    while( (word & 0x80000000u) == 0 ) { word <<= 1; num_zeros++; }
+    return num_zeros;
+#endif
+}
+
+} //namespace MultiPlotLinesInternal
+} //namespace ImGui
+
+#endif //IMGUI_MULTIPLOTLINES_INTERNAL
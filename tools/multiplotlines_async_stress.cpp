@@ -0,0 +1,192 @@
+//----------------------------------------------------------------
+// ImGui::MultiPlotLines_AsyncPipeline stress test
+//----------------------------------------------------------------
+// Runs a MultiPlotLines_AsyncPipeline headlessly, without an ImGui
+// context, with a producer thread pushing frames as fast as the queue
+// allows while the reader (UI) thread acquires snapshots and changes
+// the number of columns, so that snapshots change size (raw values vs
+// envelopes, growing ring buffer) and content on every publish.
+//
+// Frame k pushes k*(c+1) into channel c, so any torn snapshot (mixing
+// values or sizes of different publishes) breaks one of the checks:
+// - Sizes: NumValues vs NumSourceValues and columns, buffer sizes
+// - Channels: channel c values are exactly (c+1) times channel 0 ones
+// - Time: raw values are consecutive frames, and envelope columns are
+//   consecutive min/max ranges
+// - Ranges: match the values and span NumSourceValues frames
+// - Generation: never decreases, and content only changes with it
+//
+// Build with -fsanitize=thread to also check the lock-free handoff.
+// Returns 0 if all snapshots are consistent.
+//
+// Usage:
+//   multiplotlines_async_stress [--channels N] [--capacity N] [--frames N] [--seconds S]
+#include "imgui_multiplotlines_async.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+
+namespace
+{
+
+typedef ImGui::MultiPlotLines_AsyncPipeline::Snapshot Snapshot;
+
+// Frames are exact in float as long as num_frames*num_channels < 2^24
+const int c_MaxExactValue = 1 << 24;
+
+// Returns nullptr if snapshot is consistent, or the failed check
+const char* CheckSnapshot( const Snapshot& snapshot, int num_channels, int capacity )
+{
+    if( snapshot.Generation == 0 )
+        return snapshot.NumValues == 0 ? nullptr : "unpublished snapshot has values";
+    if( snapshot.NumChannels != num_channels )
+        return "NumChannels";
+    if( snapshot.NumSourceValues < 0 || snapshot.NumSourceValues > capacity )
+        return "NumSourceValues";
+    const bool bEnvelope = snapshot.NumValues != snapshot.NumSourceValues;
+    if( bEnvelope && (snapshot.NumValues % 2 != 0 || snapshot.NumSourceValues <= snapshot.NumValues) )
+        return "NumValues";
+    if( snapshot.Values.Size != num_channels * snapshot.NumValues || snapshot.Ranges.Size != num_channels )
+        return "buffer sizes";
+    if( snapshot.NumValues == 0 )
+        return nullptr;
+
+    const float* values0 = snapshot.Values.Data;
+    for( int it_channel=0; it_channel<num_channels; it_channel++ )
+    {
+        const float scale = float(it_channel+1);
+        const float* values = snapshot.Values.Data + it_channel * snapshot.NumValues;
+        float v_min = values[0], v_max = values[0];
+        for( int it_value=0; it_value<snapshot.NumValues; it_value++ )
+        {
+            if( values[it_value] != scale * values0[it_value] )
+                return "channels from different publishes";
+            v_min = values[it_value] < v_min ? values[it_value] : v_min;
+            v_max = values[it_value] > v_max ? values[it_value] : v_max;
+        }
+        const ImVec2& range = snapshot.Ranges[it_channel];
+        if( range.x != v_min || range.y != v_max )
+            return "range vs values";
+        if( range.y - range.x != scale * float(snapshot.NumSourceValues-1) )
+            return "range vs NumSourceValues";
+    }
+
+    // Consecutive frames, or consecutive columns of consecutive frames
+    if( !bEnvelope )
+    {
+        for( int it_value=1; it_value<snapshot.NumValues; it_value++ )
+            if( values0[it_value] != values0[it_value-1] + 1.0f )
+                return "raw values are not consecutive frames";
+    }
+    else
+    {
+        float last_max = -1.0f;
+        for( int it_column=0; 2*it_column<snapshot.NumValues; it_column++ )
+        {
+            const float a = values0[2*it_column], b = values0[2*it_column+1];
+            const float column_min = a < b ? a : b, column_max = a < b ? b : a;
+            if( it_column > 0 && column_min != last_max + 1.0f )
+                return "envelope columns are not consecutive";
+            last_max = column_max;
+        }
+    }
+    return nullptr;
+}
+
+int Usage( const char* program )
+{
+    fprintf( stderr, "Usage: %s [--channels N] [--capacity N] [--frames N] [--seconds S]\n", program );
+    return 1;
+}
+
+} //namespace
+
+int main( int argc, char** argv )
+{
+    int num_channels = 8;
+    int capacity = 20000;
+    int num_frames = 1000000;
+    double max_seconds = 10.0;
+    for( int it_arg=1; it_arg<argc; it_arg++ )
+    {
+        if( !strcmp( argv[it_arg], "--channels" ) && it_arg+1 < argc )
+            num_channels = atoi( argv[++it_arg] );
+        else if( !strcmp( argv[it_arg], "--capacity" ) && it_arg+1 < argc )
+            capacity = atoi( argv[++it_arg] );
+        else if( !strcmp( argv[it_arg], "--frames" ) && it_arg+1 < argc )
+            num_frames = atoi( argv[++it_arg] );
+        else if( !strcmp( argv[it_arg], "--seconds" ) && it_arg+1 < argc )
+            max_seconds = atof( argv[++it_arg] );
+        else
+            return Usage( argv[0] );
+    }
+    if( num_channels <= 0 || capacity <= 0 || num_frames <= 0 )
+        return Usage( argv[0] );
+    if( (long long)num_frames * num_channels >= c_MaxExactValue )
+    {
+        fprintf( stderr, "--frames * --channels must be below %d, so that values are exact\n", c_MaxExactValue );
+        return 1;
+    }
+
+    ImGui::MultiPlotLines_AsyncPipeline pipeline;
+    pipeline.IdleSleepUs = 10;
+    pipeline.Start( num_channels, capacity, 256 );
+
+    // Producer, retries on a full queue so that frames are consecutive
+    std::atomic<bool> bStop{false};
+    std::atomic<int> num_pushed{0};
+    std::thread producer( [&]()
+        {
+            ImVector<float> frame;
+            frame.resize( num_channels );
+            for( int it_frame=0; it_frame<num_frames && !bStop.load( std::memory_order_relaxed ); )
+            {
+                for( int it_channel=0; it_channel<num_channels; it_channel++ )
+                    frame[it_channel] = float(it_frame) * float(it_channel+1);
+                if( pipeline.Push( frame.Data ) )
+                    num_pushed.store( ++it_frame, std::memory_order_relaxed );
+                else
+                    std::this_thread::yield();
+            }
+        } );
+
+    // Reader, checks every acquired snapshot while changing columns
+    typedef std::chrono::steady_clock Clock;
+    const Clock::time_point t0 = Clock::now();
+    const int c_Columns[] = { 1, 7, 64, 500, 1024, 4096, 20000 };
+    ImU32 last_generation = 0;
+    int last_num_values = 0;
+    float last_first_value = 0.0f;
+    long long num_checked = 0, num_published = 0, num_failed = 0;
+    for( int it_iter=0; ; it_iter++ )
+    {
+        if( it_iter % 64 == 0 )
+            pipeline.SetNumColumns( c_Columns[(it_iter/64) % IM_ARRAYSIZE(c_Columns)] );
+        const Snapshot& snapshot = *pipeline.AcquireSnapshot();
+        const char* failure = CheckSnapshot( snapshot, num_channels, capacity );
+        if( !failure && snapshot.Generation < last_generation )
+            failure = "generation decreased";
+        if( !failure && snapshot.Generation == last_generation && snapshot.NumValues > 0
+            && (snapshot.NumValues != last_num_values || snapshot.Values[0] != last_first_value) )
+            failure = "content changed without generation";
+        if( failure && num_failed++ < 10 )
+            fprintf( stderr, "Snapshot generation %u: %s\n", snapshot.Generation, failure );
+        num_published += snapshot.Generation != last_generation ? 1 : 0;
+        last_generation = snapshot.Generation;
+        last_num_values = snapshot.NumValues;
+        last_first_value = snapshot.NumValues > 0 ? snapshot.Values[0] : 0.0f;
+        num_checked++;
+
+        const double seconds = std::chrono::duration<double>( Clock::now() - t0 ).count();
+        if( num_pushed.load( std::memory_order_relaxed ) == num_frames || seconds > max_seconds )
+            break;
+    }
+    bStop.store( true );
+    producer.join();
+    pipeline.Stop();
+
+    printf( "frames %d, snapshots checked %lld, published %lld, failed %lld, dropped %u\n",
+            num_pushed.load(), num_checked, num_published, num_failed, pipeline.NumDropped.load() );
+    return num_failed == 0 && num_published > 1 ? 0 : 1;
+}
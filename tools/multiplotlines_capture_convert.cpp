@@ -0,0 +1,167 @@
+//----------------------------------------------------------------
+// ImGui::MultiPlotLines capture converter
+//----------------------------------------------------------------
+// Converts a raw interleaved dump (frames of one value per channel,
+// little-endian, no framing) into a MultiPlotLines_Capture file and its
+// sidecar index, streaming it in chunks so that dumps larger than
+// memory can be converted. Values are converted to float as
+// scale*value + offset.
+//
+// Usage:
+//   multiplotlines_capture_convert --channels N [--type T] [--skip BYTES]
+//                                  [--scale S] [--offset O] input.raw output.mplcap
+// T is one of f32 (default), f64, i8, u8, i16, u16, i32, u32
+#include "imgui_multiplotlines_capture.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+namespace
+{
+
+enum EType { eT_F32, eT_F64, eT_I8, eT_U8, eT_I16, eT_U16, eT_I32, eT_U32, eT_Count };
+const char* c_TypeNames[eT_Count] = { "f32", "f64", "i8", "u8", "i16", "u16", "i32", "u32" };
+const int   c_TypeSizes[eT_Count] = { 4, 8, 1, 1, 2, 2, 4, 4 };
+
+template <typename T>
+void ConvertValues( const unsigned char* raw, int num_values, float scale, float offset, float* values )
+{
+    for( int i=0; i<num_values; i++ )
+    {
+        T v;
+        memcpy( &v, raw + (size_t)i*sizeof(T), sizeof(T) );
+        values[i] = scale * (float)v + offset;
+    }
+}
+
+void Convert( int type, const unsigned char* raw, int num_values, float scale, float offset, float* values )
+{
+    switch( type )
+    {
+    case eT_F32: ConvertValues<float>( raw, num_values, scale, offset, values ); break;
+    case eT_F64: ConvertValues<double>( raw, num_values, scale, offset, values ); break;
+    case eT_I8:  ConvertValues<ImS8>( raw, num_values, scale, offset, values ); break;
+    case eT_U8:  ConvertValues<ImU8>( raw, num_values, scale, offset, values ); break;
+    case eT_I16: ConvertValues<ImS16>( raw, num_values, scale, offset, values ); break;
+    case eT_U16: ConvertValues<ImU16>( raw, num_values, scale, offset, values ); break;
+    case eT_I32: ConvertValues<ImS32>( raw, num_values, scale, offset, values ); break;
+    default:     ConvertValues<ImU32>( raw, num_values, scale, offset, values ); break;
+    }
+}
+
+int Usage( const char* program )
+{
+    fprintf( stderr, "Usage: %s --channels N [--type f32|f64|i8|u8|i16|u16|i32|u32] [--skip BYTES] [--scale S] [--offset O] input.raw output.mplcap\n", program );
+    return 1;
+}
+
+} //namespace
+
+int main( int argc, char** argv )
+{
+    int num_channels = 0;
+    int type = eT_F32;
+    long long skip_bytes = 0;
+    float scale = 1.0f, offset = 0.0f;
+    const char* input_path = nullptr;
+    const char* output_path = nullptr;
+    for( int it_arg=1; it_arg<argc; it_arg++ )
+    {
+        if( !strcmp( argv[it_arg], "--channels" ) && it_arg+1 < argc )
+            num_channels = atoi( argv[++it_arg] );
+        else if( !strcmp( argv[it_arg], "--type" ) && it_arg+1 < argc )
+        {
+            const char* type_name = argv[++it_arg];
+            for( type=0; type<eT_Count && strcmp( type_name, c_TypeNames[type] ); type++ ) {}
+            if( type == eT_Count )
+                return Usage( argv[0] );
+        }
+        else if( !strcmp( argv[it_arg], "--skip" ) && it_arg+1 < argc )
+            skip_bytes = atoll( argv[++it_arg] );
+        else if( !strcmp( argv[it_arg], "--scale" ) && it_arg+1 < argc )
+            scale = (float)atof( argv[++it_arg] );
+        else if( !strcmp( argv[it_arg], "--offset" ) && it_arg+1 < argc )
+            offset = (float)atof( argv[++it_arg] );
+        else if( argv[it_arg][0] != '-' && !input_path )
+            input_path = argv[it_arg];
+        else if( argv[it_arg][0] != '-' && !output_path )
+            output_path = argv[it_arg];
+        else
+            return Usage( argv[0] );
+    }
+    if( num_channels <= 0 || skip_bytes < 0 || !input_path || !output_path )
+        return Usage( argv[0] );
+    const int max_channels = 0x7FFFFFFF / ImGui::MultiPlotLines_CaptureWriter::cChunkFrames;
+    if( num_channels > max_channels )
+    {
+        fprintf( stderr, "--channels %d exceeds the %d channels supported\n", num_channels, max_channels );
+        return 1;
+    }
+
+    // Whole frames after the skipped header, a trailing partial frame is ignored
+    struct stat st;
+    if( stat( input_path, &st ) != 0 )
+    {
+        fprintf( stderr, "Can't stat '%s'\n", input_path );
+        return 1;
+    }
+    const long long frame_bytes = (long long)num_channels * c_TypeSizes[type];
+    const long long num_frames = st.st_size > skip_bytes ? (st.st_size - skip_bytes) / frame_bytes : 0;
+    if( num_frames < 2 || num_frames > 0x7FFFFFFF )
+    {
+        fprintf( stderr, "'%s' has %lld frames of %d channels, expected [2,2^31)\n", input_path, num_frames, num_channels );
+        return 1;
+    }
+
+    FILE* input = fopen( input_path, "rb" );
+    if( !input )
+    {
+        fprintf( stderr, "Can't open '%s'\n", input_path );
+        return 1;
+    }
+    ImGui::MultiPlotLines_CaptureWriter writer;
+    if( !writer.Open( output_path, num_channels, (int)num_frames ) )
+    {
+        fprintf( stderr, "Can't create '%s'\n", output_path );
+        fclose( input );
+        return 1;
+    }
+
+    // Stream frames in chunks, fewer frames than the writer ones if
+    // their raw bytes wouldn't fit in an ImVector (ex: many f64 channels)
+    const long long max_chunk_frames = 0x7FFFFFFF / frame_bytes;
+    const long long writer_chunk_frames = ImGui::MultiPlotLines_CaptureWriter::cChunkFrames;
+    const int chunk_frames = (int)( max_chunk_frames < writer_chunk_frames ? max_chunk_frames : writer_chunk_frames );
+    ImVector<unsigned char> raw;
+    ImVector<float> frames;
+    raw.resize( (int)(chunk_frames * frame_bytes) );
+    frames.resize( chunk_frames * num_channels );
+    bool bOk = true;
+    for( long long it_frame=0; bOk && it_frame<num_frames; it_frame+=chunk_frames )
+    {
+        const int count = (int)( num_frames - it_frame < chunk_frames ? num_frames - it_frame : chunk_frames );
+        // Skip header bytes by reading them, so that pipes of known size work too
+        for( ; bOk && skip_bytes > 0; )
+        {
+            const size_t skip_chunk = (size_t)( skip_bytes < raw.Size ? skip_bytes : raw.Size );
+            bOk = fread( raw.Data, 1, skip_chunk, input ) == skip_chunk;
+            skip_bytes -= (long long)skip_chunk;
+        }
+        bOk = bOk && fread( raw.Data, (size_t)frame_bytes, (size_t)count, input ) == (size_t)count;
+        if( bOk )
+        {
+            Convert( type, raw.Data, count * num_channels, scale, offset, frames.Data );
+            bOk = writer.Push( frames.Data, count );
+        }
+    }
+    fclose( input );
+    bOk = writer.Close() && bOk;
+    if( !bOk )
+    {
+        fprintf( stderr, "Conversion of '%s' into '%s' failed\n", input_path, output_path );
+        return 1;
+    }
+    fprintf( stderr, "Converted %lld frames of %d channels into '%s' and '%s.idx'\n", num_frames, num_channels, output_path, output_path );
+    return 0;
+}